@@ -0,0 +1,175 @@
+/*
+ * Decawave DW1000 library for arduino.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file AntennaCalibration.ino
+ * Calibrates the antenna delays of NODE_COUNT (>= 3) nodes placed at known positions.
+ *
+ * Flash every node with its own THIS_NODE. The node with THIS_NODE == COLLECTOR ranges
+ * as tag with all others (anchors) and prints every result as a line "m <i> <j> <range>".
+ * Ranges between the anchors are needed as well: repeat the run with another COLLECTOR
+ * and send the printed lines of all runs to the node that solves, e.g.
+ * `cat run*.log | grep ^m > /dev/ttyUSB0`. Send "s" to solve; the antenna delays of all
+ * nodes and the residual error are printed and the record is stored in EEPROM. Send the
+ * same lines to the other nodes (or copy the EEPROM record), every node applies its own
+ * delay at the next start. "x" erases the record to calibrate again.
+ */
+#include <SPI.h>
+#include "DW1000Ranging.h"
+#include "DW1000AntennaCalibration.h"
+#if defined(ARDUINO_ARCH_AVR) || defined(ESP8266)
+#include <EEPROM.h>
+#define HAVE_EEPROM
+#endif
+
+// connection pins
+const uint8_t PIN_RST = 9; // reset pin
+const uint8_t PIN_IRQ = 2; // irq pin
+const uint8_t PIN_SS = SS; // spi select pin
+
+// the nodes and their antenna positions [m]
+const uint8_t NODE_COUNT = 3;
+const float NODE_X[NODE_COUNT] = { 0.0f, 5.0f, 0.0f };
+const float NODE_Y[NODE_COUNT] = { 0.0f, 0.0f, 4.0f };
+const uint8_t THIS_NODE = 0;
+const uint8_t COLLECTOR = 0;
+// all nodes range with this delay until they are calibrated
+const uint16_t BASE_DELAY = 16384;
+// where the record is stored
+const int EEPROM_ADDRESS = 0;
+
+DW1000AntennaCalibration calibration(NODE_COUNT, BASE_DELAY);
+AntennaCalibrationRecord record;
+boolean calibrated = false;
+char line[32];
+uint8_t lineLength = 0;
+
+float trueDistance(uint8_t a, uint8_t b) {
+  float dx = NODE_X[a] - NODE_X[b];
+  float dy = NODE_Y[a] - NODE_Y[b];
+  return sqrt(dx*dx + dy*dy);
+}
+
+void setup() {
+  Serial.begin(115200);
+  delay(1000);
+  Serial.println(F("### DW1000-arduino-antenna-calibration ###"));
+  DW1000Ranging.initCommunication(PIN_RST, PIN_SS, PIN_IRQ);
+  DW1000Ranging.attachNewRange(newRange);
+#ifdef HAVE_EEPROM
+#ifdef ESP8266
+  EEPROM.begin(sizeof(record));
+#endif
+  EEPROM.get(EEPROM_ADDRESS, record);
+#endif
+  calibrated = DW1000AntennaCalibration::apply(record, THIS_NODE);
+  if(!calibrated) {
+    DW1000.setAntennaDelay(BASE_DELAY);
+  }
+  Serial.print(F("Antenna delay: ")); Serial.print(DW1000.getAntennaDelay());
+  Serial.println(calibrated ? F(" (calibrated)") : F(" (base, collecting measurements)"));
+  // both bytes of the short address are the node number, independent of their order
+  char address[] = "01:01:22:EA:82:60:3B:9C";
+  address[1] = address[4] = '1' + THIS_NODE;
+  if(THIS_NODE == COLLECTOR) {
+    DW1000Ranging.startAsTag(address, DW1000.MODE_LONGDATA_RANGE_ACCURACY, false);
+  } else {
+    DW1000Ranging.startAsAnchor(address, DW1000.MODE_LONGDATA_RANGE_ACCURACY, false);
+  }
+}
+
+void loop() {
+  DW1000Ranging.loop();
+  while(Serial.available()) {
+    char c = Serial.read();
+    if(c == '\n' || c == '\r') {
+      line[lineLength] = '\0';
+      if(lineLength > 0) {
+        command(line);
+      }
+      lineLength = 0;
+    } else if(lineLength < sizeof(line) - 1) {
+      line[lineLength++] = c;
+    }
+  }
+}
+
+void newRange() {
+  uint8_t node = (DW1000Ranging.getDistantDevice()->getShortAddress() & 0xFF) - 1;
+  if(node >= NODE_COUNT || node == THIS_NODE) {
+    return;
+  }
+  float range = DW1000Ranging.getDistantDevice()->getRange();
+  if(calibrated) {
+    Serial.print(F("node ")); Serial.print(node);
+    Serial.print(F("\t range: ")); Serial.print(range);
+    Serial.print(F(" m\t error: ")); Serial.print(range - trueDistance(THIS_NODE, node)); Serial.println(F(" m"));
+    return;
+  }
+  addMeasurement(THIS_NODE, node, range);
+  Serial.print(F("m ")); Serial.print(THIS_NODE); Serial.print(' '); Serial.print(node); Serial.print(' ');
+  Serial.println(range, 3);
+}
+
+void addMeasurement(uint8_t a, uint8_t b, float range) {
+  if(a < NODE_COUNT && b < NODE_COUNT) {
+    calibration.addMeasurement(a, b, range, trueDistance(a, b));
+  }
+}
+
+void command(char* text) {
+  char* next;
+  if(text[0] == 'm') {
+    uint8_t a = strtol(text + 1, &next, 10);
+    uint8_t b = strtol(next, &next, 10);
+    addMeasurement(a, b, strtod(next, &next));
+  } else if(text[0] == 's') {
+    solve();
+  } else if(text[0] == 'x') {
+    memset(&record, 0, sizeof(record));
+    storeRecord();
+    Serial.println(F("Record erased, restart to calibrate"));
+  }
+}
+
+void solve() {
+  for(uint8_t a = 0; a < NODE_COUNT; a++) {
+    for(uint8_t b = a + 1; b < NODE_COUNT; b++) {
+      Serial.print(F("pair ")); Serial.print(a); Serial.print('-'); Serial.print(b);
+      Serial.print(F(": ")); Serial.println(calibration.getMeasurementCount(a, b));
+    }
+  }
+  if(!calibration.solve(record)) {
+    Serial.println(F("Not enough pairs measured to determine all delays"));
+    return;
+  }
+  for(uint8_t i = 0; i < NODE_COUNT; i++) {
+    Serial.print(F("node ")); Serial.print(i); Serial.print(F(" antenna delay: ")); Serial.println(record.antennaDelay[i]);
+  }
+  Serial.print(F("residual error [m]: ")); Serial.print(record.residualError, 3);
+  Serial.print(F(" from ")); Serial.print(record.measurements); Serial.println(F(" measurements"));
+  storeRecord();
+}
+
+void storeRecord() {
+#ifdef HAVE_EEPROM
+  EEPROM.put(EEPROM_ADDRESS, record);
+#ifdef ESP8266
+  EEPROM.commit();
+#endif
+  Serial.println(F("Record stored in EEPROM"));
+#else
+  Serial.println(F("No EEPROM, enter the antenna delay with setAntennaDelay()"));
+#endif
+}
@@ -38,12 +38,22 @@ void setup() {
   DW1000.begin(PIN_IRQ, PIN_RST);
   DW1000.select(PIN_SS);
   Serial.println(F("DW1000 initialized ..."));
+  // how long the start up took (in microseconds)
+  const DW1000Class::BootProfile& boot = DW1000.getBootProfile();
+  Serial.print(F("Boot [us]: wakeup ")); Serial.print(boot.wakeup);
+  Serial.print(F(", reset ")); Serial.print(boot.reset);
+  Serial.print(F(", setup ")); Serial.print(boot.setup);
+  Serial.print(F(", LDE ")); Serial.print(boot.lde);
+  Serial.print(F(", OTP ")); Serial.print(boot.otp);
+  Serial.print(F(", total ")); Serial.print(boot.total);
+  Serial.print(F(", timeouts ")); Serial.println(boot.timeouts);
   // general configuration
   DW1000.newConfiguration();
   DW1000.setDeviceAddress(5);
   DW1000.setNetworkId(10);
   DW1000.commitConfiguration();
-  Serial.println(F("Committed configuration ..."));
+  Serial.print(F("Committed configuration in ")); Serial.print(DW1000.getBootProfile().configure);
+  Serial.println(F(" us ..."));
   // wait a bit
   delay(1000);
 }
@@ -96,9 +96,12 @@ void loop() {
     DW1000.getData(message);
     Serial.print("Received message ... #"); Serial.println(numReceived);
     Serial.print("Data is ... "); Serial.println(message);
-    Serial.print("FP power is [dBm] ... "); Serial.println(DW1000.getFirstPathPower());
-    Serial.print("RX power is [dBm] ... "); Serial.println(DW1000.getReceivePower());
-    Serial.print("Signal quality is ... "); Serial.println(DW1000.getReceiveQuality());
+    // read all receive diagnostics at once
+    DW1000Class::RxDiagnostics diag;
+    DW1000.getReceiveDiagnostics(diag);
+    Serial.print("FP power is [dBm] ... "); Serial.println(DW1000.getFirstPathPower(diag));
+    Serial.print("RX power is [dBm] ... "); Serial.println(DW1000.getReceivePower(diag));
+    Serial.print("Signal quality is ... "); Serial.println(DW1000.getReceiveQuality(diag));
     received = false;
   }
   if (error) {
@@ -0,0 +1,135 @@
+/*
+ * Decawave DW1000 library for arduino.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file CIRCapture.ino
+ * Captures the channel impulse response (accumulator memory) of every received
+ * frame and streams it in binary form over Serial. Use it together with the
+ * "BasicSender" example sketch and decode the captures on the host with
+ * extras/tools/cir_decode.py.
+ *
+ * Frame format (all values little endian):
+ *  - magic "CIR" and format version (4 bytes)
+ *  - frame number, first path index (10.6 fixed point), first tap, number of taps (2 bytes each)
+ *  - taps, 2 bytes signed real and 2 bytes signed imaginary part each
+ *  - accumulator readout time in microseconds (4 bytes)
+ *  - 16 bit sum of all bytes following the magic and version (2 bytes)
+ */
+#include <SPI.h>
+#include <DW1000.h>
+
+// connection pins
+const uint8_t PIN_RST = 9; // reset pin
+const uint8_t PIN_IRQ = 2; // irq pin
+const uint8_t PIN_SS = SS; // spi select pin
+
+// capture the full impulse response, or only a window around the first path
+const boolean FULL_CIR = false;
+const uint16_t WINDOW_TAPS_BEFORE = 16;
+const uint16_t WINDOW_TAPS = 64;
+// taps read per SPI burst (buffer is CHUNK_TAPS * LEN_ACC_SAMPLE bytes)
+const uint16_t CHUNK_TAPS = 16;
+
+const byte CIR_MAGIC[] = {'C', 'I', 'R', 0x01};
+
+volatile boolean received = false;
+uint16_t numFrames = 0;
+byte chunk[CHUNK_TAPS * LEN_ACC_SAMPLE];
+uint16_t checksum = 0;
+uint32_t streamTime = 0;
+
+void setup() {
+  // the faster the line, the higher the capture rate
+  Serial.begin(115200);
+  // initialize the driver
+  DW1000.begin(PIN_IRQ, PIN_RST);
+  DW1000.select(PIN_SS);
+  // general configuration
+  DW1000.newConfiguration();
+  DW1000.setDefaults();
+  DW1000.setDeviceAddress(6);
+  DW1000.setNetworkId(10);
+  DW1000.enableMode(DW1000.MODE_LONGDATA_RANGE_LOWPOWER);
+  DW1000.commitConfiguration();
+  DW1000.attachReceivedHandler(handleReceived);
+  receiver();
+}
+
+void handleReceived() {
+  received = true;
+}
+
+void receiver() {
+  DW1000.newReceive();
+  DW1000.setDefaults();
+  // no automatic re-enabling, the next frame would overwrite the accumulator
+  DW1000.receivePermanently(false);
+  DW1000.startReceive();
+}
+
+void writeChecked(const byte data[], uint16_t n) {
+  for(uint16_t i = 0; i < n; i++) {
+    checksum += data[i];
+  }
+  Serial.write(data, n);
+}
+
+void writeChecked16(uint16_t val) {
+  byte data[] = {(byte)val, (byte)(val >> 8)};
+  writeChecked(data, 2);
+}
+
+void handleChunk(const byte data[], uint16_t firstTap, uint16_t numTaps) {
+  // time spent on Serial is not part of the readout time
+  uint32_t start = micros();
+  writeChecked(data, numTaps * LEN_ACC_SAMPLE);
+  streamTime += micros() - start;
+}
+
+void loop() {
+  if(!received) {
+    return;
+  }
+  received = false;
+  DW1000Class::RxDiagnostics diag;
+  DW1000.getReceiveDiagnostics(diag);
+  uint16_t firstTap = 0;
+  uint16_t numTaps = DW1000.getAccumulatorLength();
+  if(!FULL_CIR) {
+    firstTap = DW1000.getAccumulatorWindowStart(diag, WINDOW_TAPS_BEFORE);
+    numTaps -= firstTap;
+    if(numTaps > WINDOW_TAPS) {
+      numTaps = WINDOW_TAPS;
+    }
+  }
+  // header
+  Serial.write(CIR_MAGIC, sizeof(CIR_MAGIC));
+  checksum = 0;
+  writeChecked16(numFrames++);
+  writeChecked16(diag.firstPathIndex);
+  writeChecked16(firstTap);
+  writeChecked16(numTaps);
+  // taps
+  streamTime = 0;
+  uint32_t start = micros();
+  DW1000.getAccumulator(firstTap, numTaps, chunk, CHUNK_TAPS, handleChunk);
+  uint32_t readoutTime = micros() - start - streamTime;
+  // trailer
+  writeChecked16((uint16_t)readoutTime);
+  writeChecked16((uint16_t)(readoutTime >> 16));
+  byte sum[] = {(byte)checksum, (byte)(checksum >> 8)};
+  Serial.write(sum, 2);
+  // ready for the next frame
+  receiver();
+}
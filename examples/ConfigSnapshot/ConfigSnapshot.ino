@@ -0,0 +1,88 @@
+/*
+ * Decawave DW1000 library for arduino.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file ConfigSnapshot.ino
+ * Stores the configuration of the DW1000 in EEPROM on the first start and
+ * restores it from there on every following start, which skips building the
+ * configuration again. Boards without EEPROM print the snapshot as hex instead,
+ * so it can be kept on the host.
+ */
+#include <SPI.h>
+#include <DW1000.h>
+#if defined(ARDUINO_ARCH_AVR) || defined(ESP8266)
+#include <EEPROM.h>
+#define HAVE_EEPROM
+#endif
+
+// connection pins
+const uint8_t PIN_RST = 9; // reset pin
+const uint8_t PIN_IRQ = 2; // irq pin
+const uint8_t PIN_SS = SS; // spi select pin
+
+// where the snapshot is stored
+const int EEPROM_ADDRESS = 0;
+
+DW1000Class::ConfigSnapshot snapshot;
+
+void setup() {
+  Serial.begin(115200);
+  Serial.println(F("### DW1000-arduino-config-snapshot ###"));
+  DW1000.begin(PIN_IRQ, PIN_RST);
+  DW1000.select(PIN_SS);
+#ifdef HAVE_EEPROM
+#ifdef ESP8266
+  EEPROM.begin(sizeof(snapshot));
+#endif
+  EEPROM.get(EEPROM_ADDRESS, snapshot);
+#endif
+  uint32_t start = micros();
+  if(DW1000.restoreConfigSnapshot(snapshot)) {
+    Serial.print(F("Restored configuration from snapshot [us]: ")); Serial.println(micros() - start);
+  } else {
+    // no (valid) snapshot yet: build the configuration and keep it
+    DW1000.newConfiguration();
+    DW1000.setDefaults();
+    DW1000.setDeviceAddress(7);
+    DW1000.setNetworkId(10);
+    DW1000.enableMode(DW1000.MODE_LONGDATA_RANGE_ACCURACY);
+    DW1000.commitConfiguration();
+    Serial.print(F("Built configuration [us]: ")); Serial.println(micros() - start);
+    DW1000.getConfigSnapshot(snapshot);
+#ifdef HAVE_EEPROM
+    EEPROM.put(EEPROM_ADDRESS, snapshot);
+#ifdef ESP8266
+    EEPROM.commit();
+#endif
+    Serial.println(F("Snapshot stored in EEPROM"));
+#else
+    const byte* bytes = (const byte*)&snapshot;
+    for(uint16_t i = 0; i < sizeof(snapshot); i++) {
+      if(bytes[i] < 0x10) {
+        Serial.print('0');
+      }
+      Serial.print(bytes[i], HEX);
+    }
+    Serial.println();
+#endif
+  }
+  char msg[128];
+  DW1000.getPrintableNetworkIdAndShortAddress(msg);
+  Serial.print(F("Network ID & Device Address: ")); Serial.println(msg);
+  DW1000.getPrintableDeviceMode(msg);
+  Serial.print(F("Device mode: ")); Serial.println(msg);
+}
+
+void loop() {
+}
@@ -24,6 +24,10 @@ void setup() {
   DW1000Ranging.attachInactiveDevice(inactiveDevice);
   //Enable the filter to smooth the distance
   //DW1000Ranging.useRangeFilter(true);
+  //Hop channels from ranging round to ranging round (tags follow the anchor's hopping sequence)
+  //DW1000Ranging.useChannelHopping(HOP_CHANNELS_DEFAULT);
+  //Compensate temperature and battery voltage drift (sampled from the ranging loop)
+  //DW1000.useTempAndVbatCompensation(true);
   
   //we start the module as an anchor
   DW1000Ranging.startAsAnchor("82:17:5B:D5:A9:9A:E2:9C", DW1000.MODE_LONGDATA_RANGE_ACCURACY);
@@ -36,7 +40,8 @@ void loop() {
 void newRange() {
   Serial.print("from: "); Serial.print(DW1000Ranging.getDistantDevice()->getShortAddress(), HEX);
   Serial.print("\t Range: "); Serial.print(DW1000Ranging.getDistantDevice()->getRange()); Serial.print(" m");
-  Serial.print("\t RX power: "); Serial.print(DW1000Ranging.getDistantDevice()->getRXPower()); Serial.println(" dBm");
+  Serial.print("\t RX power: "); Serial.print(DW1000Ranging.getDistantDevice()->getRXPower()); Serial.print(" dBm");
+  Serial.print("\t rate: "); Serial.print(DW1000Ranging.getDistantDevice()->getRangeRate()); Serial.println(" Hz");
 }
 
 void newBlink(DW1000Device* device) {
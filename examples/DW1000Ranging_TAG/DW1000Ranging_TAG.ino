@@ -24,6 +24,10 @@ void setup() {
   DW1000Ranging.attachInactiveDevice(inactiveDevice);
   //Enable the filter to smooth the distance
   //DW1000Ranging.useRangeFilter(true);
+  //Hop channels from ranging round to ranging round (follows the anchor's hopping sequence)
+  //DW1000Ranging.useChannelHopping(HOP_CHANNELS_DEFAULT);
+  //Trim our crystal towards the clock of the anchors
+  //DW1000Ranging.useCrystalTrimming(true);
   
   //we start the module as a tag
   DW1000Ranging.startAsTag("7D:00:22:EA:82:60:3B:9C", DW1000.MODE_LONGDATA_RANGE_ACCURACY);
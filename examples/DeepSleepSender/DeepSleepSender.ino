@@ -0,0 +1,75 @@
+/*
+ * Decawave DW1000 library for arduino.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file DeepSleepSender.ino
+ * Duty-cycled sender: the DW1000 wakes up, sends one frame and goes back to
+ * deep sleep, keeping its configuration over sleep. Prints how long the
+ * wake-up took. Frames can be received with the "BasicReceiver" example sketch.
+ */
+#include <SPI.h>
+#include <DW1000.h>
+
+// connection pins
+const uint8_t PIN_RST = 9; // reset pin
+const uint8_t PIN_IRQ = 2; // irq pin
+const uint8_t PIN_SS = SS; // spi select pin
+
+// time between two frames (the DW1000 sleeps meanwhile)
+const uint32_t SLEEP_PERIOD_MS = 1000;
+
+volatile boolean sentAck = false;
+uint16_t sentNum = 0;
+
+void setup() {
+  Serial.begin(9600);
+  Serial.println(F("### DW1000-arduino-deep-sleep-sender ###"));
+  // initialize the driver (only once, wake-ups restore the configuration)
+  DW1000.begin(PIN_IRQ, PIN_RST);
+  DW1000.select(PIN_SS);
+  DW1000.newConfiguration();
+  DW1000.setDefaults();
+  DW1000.setDeviceAddress(6);
+  DW1000.setNetworkId(10);
+  DW1000.enableMode(DW1000.MODE_LONGDATA_RANGE_LOWPOWER);
+  DW1000.commitConfiguration();
+  DW1000.attachSentHandler(handleSent);
+  Serial.print(F("Boot [us]: ")); Serial.println(DW1000.getBootProfile().total);
+  DW1000.deepSleep();
+}
+
+void handleSent() {
+  sentAck = true;
+}
+
+void loop() {
+  delay(SLEEP_PERIOD_MS);
+  if(!DW1000.spiWakeup()) {
+    Serial.println(F("DW1000 did not wake up"));
+    return;
+  }
+  Serial.print(F("Wake-up [us]: ")); Serial.println(DW1000.getWakeLatency());
+  // send one frame
+  DW1000.newTransmit();
+  DW1000.setDefaults();
+  String msg = "Hello DW1000, it's #"; msg += sentNum;
+  DW1000.setData(msg);
+  DW1000.startTransmit();
+  uint32_t start = millis();
+  while(!sentAck && millis() - start < 50) {
+  }
+  sentAck = false;
+  sentNum++;
+  DW1000.deepSleep();
+}
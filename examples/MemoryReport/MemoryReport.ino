@@ -0,0 +1,46 @@
+/*
+ * Decawave DW1000 library for arduino.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file MemoryReport.ino
+ * Prints the SRAM the ranging device table needs on this target, to choose
+ * MAX_DEVICES (set it as compiler flag, e.g. -DMAX_DEVICES=16). On AVR the
+ * free SRAM is printed too. Needs no DW1000 module.
+ */
+
+#include <DW1000Ranging.h>
+
+#if defined(__AVR__)
+extern char* __brkval;
+extern char  __heap_start;
+
+int freeMemory() {
+  char top;
+  return &top - (__brkval != 0 ? __brkval : &__heap_start);
+}
+#endif
+
+void setup() {
+  Serial.begin(9600);
+  Serial.println(F("### DW1000 ranging memory report ###"));
+  DW1000Ranging.printMemoryReport(Serial);
+#if defined(__AVR__)
+  Serial.print(F("free SRAM: "));
+  Serial.print(freeMemory());
+  Serial.println(F(" bytes"));
+#endif
+}
+
+void loop() {
+}
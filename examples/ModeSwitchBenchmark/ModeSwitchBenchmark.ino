@@ -0,0 +1,109 @@
+/*
+ * Decawave DW1000 library for arduino.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file ModeSwitchBenchmark.ino
+ * Measures how long it takes to switch the DW1000 from one pre-defined radio
+ * profile to the next, once with a complete commitConfiguration() and once with
+ * switchMode() and mode images that were prepared in advance. After each switch
+ * the channel and transmit frame control registers are read back and checked
+ * against the target profile.
+ */
+#include <SPI.h>
+#include <DW1000.h>
+
+// connection pins
+const uint8_t PIN_RST = 9; // reset pin
+const uint8_t PIN_IRQ = 2; // irq pin
+const uint8_t PIN_SS = SS; // spi select pin
+
+// number of switches to average over, per profile
+const uint16_t ROUNDS = 50;
+
+const DW1000Profile PROFILES[] = {
+  DW1000.PROFILE_LONGDATA_RANGE_LOWPOWER,
+  DW1000.PROFILE_SHORTDATA_FAST_LOWPOWER,
+  DW1000.PROFILE_LONGDATA_FAST_LOWPOWER,
+  DW1000.PROFILE_SHORTDATA_FAST_ACCURACY,
+  DW1000.PROFILE_LONGDATA_FAST_ACCURACY,
+  DW1000.PROFILE_LONGDATA_RANGE_ACCURACY
+};
+const uint8_t NUM_PROFILES = sizeof(PROFILES) / sizeof(PROFILES[0]);
+
+DW1000Class::TuneImage images[NUM_PROFILES];
+
+void setup() {
+  Serial.begin(115200);
+  Serial.println(F("### DW1000-arduino-mode-switch-benchmark ###"));
+  // initialize the driver
+  DW1000.begin(PIN_IRQ, PIN_RST);
+  DW1000.select(PIN_SS);
+  DW1000.newConfiguration();
+  DW1000.setDefaults();
+  DW1000.setDeviceAddress(1);
+  DW1000.setNetworkId(10);
+  DW1000.commitConfiguration();
+  // prepare the mode images of all profiles once
+  for(uint8_t i = 0; i < NUM_PROFILES; i++) {
+    DW1000.newConfiguration();
+    DW1000.enableMode(PROFILES[i]);
+    DW1000.buildTuneImage(images[i]);
+  }
+  DW1000.commitConfiguration();
+  Serial.print(F("Mode image size [bytes]: ")); Serial.println(sizeof(DW1000Class::TuneImage));
+}
+
+// checks that the chip runs the mode of the image (channel, PRF, preamble code, data rate, preamble length)
+boolean isModeActive(const DW1000Class::TuneImage& image) {
+  byte chanctrl[LEN_CHAN_CTRL];
+  byte txfctrl[LEN_TX_FCTRL];
+  DW1000.readBytes(CHAN_CTRL, NO_SUB, chanctrl, LEN_CHAN_CTRL);
+  DW1000.readBytes(TX_FCTRL, NO_SUB, txfctrl, LEN_TX_FCTRL);
+  return memcmp(chanctrl, image.chanctrl, LEN_CHAN_CTRL) == 0
+    && (txfctrl[1] & 0x60) == (image.txfctrl[1] & 0x60)
+    && (txfctrl[2] & 0x3F) == (image.txfctrl[2] & 0x3F);
+}
+
+void loop() {
+  for(uint8_t i = 0; i < NUM_PROFILES; i++) {
+    uint8_t previous = (i == 0 ? NUM_PROFILES-1 : i-1);
+    uint32_t commitTime = 0;
+    uint32_t switchTime = 0;
+    boolean commitOk = true;
+    boolean switchOk = true;
+    for(uint16_t r = 0; r < ROUNDS; r++) {
+      // from the previous profile with a complete configuration
+      DW1000.switchMode(images[previous]);
+      uint32_t start = micros();
+      DW1000.newConfiguration();
+      DW1000.enableMode(PROFILES[i]);
+      DW1000.commitConfiguration();
+      commitTime += micros() - start;
+      commitOk = commitOk && isModeActive(images[i]);
+      // from the previous profile with the prepared image
+      DW1000.switchMode(images[previous]);
+      start = micros();
+      DW1000.switchMode(images[i]);
+      switchTime += micros() - start;
+      switchOk = switchOk && isModeActive(images[i]);
+    }
+    Serial.print(F("Profile ")); Serial.print(previous); Serial.print(F(" -> ")); Serial.print(i);
+    Serial.print(F(": commitConfiguration [us]: ")); Serial.print(commitTime / ROUNDS);
+    Serial.print(commitOk ? F(" (ok)") : F(" (FAILED)"));
+    Serial.print(F(", switchMode [us]: ")); Serial.print(switchTime / ROUNDS);
+    Serial.println(switchOk ? F(" (ok)") : F(" (FAILED)"));
+  }
+  Serial.println();
+  delay(5000);
+}
@@ -0,0 +1,56 @@
+/*
+ * Decawave DW1000 library for arduino.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file RegisterSnapshot.ino
+ * Streams a binary snapshot of all DW1000 registers to Serial whenever a
+ * character is received. Capture and compare the snapshots of two nodes with
+ *
+ *     reg_diff.py --port /dev/ttyUSB0 --save node1.bin
+ *     reg_diff.py --port /dev/ttyUSB1 --save node2.bin
+ *     reg_diff.py node1.bin node2.bin
+ *
+ * (see extras/tools).
+ */
+
+#include <SPI.h>
+#include <DW1000.h>
+
+// connection pins
+const uint8_t PIN_RST = 9; // reset pin
+const uint8_t PIN_IRQ = 2; // irq pin
+const uint8_t PIN_SS = SS; // spi select pin
+
+void setup() {
+  Serial.begin(115200);
+  DW1000.begin(PIN_IRQ, PIN_RST);
+  DW1000.select(PIN_SS);
+  DW1000.newConfiguration();
+  DW1000.setDefaults();
+  DW1000.setDeviceAddress(5);
+  DW1000.setNetworkId(10);
+  DW1000.enableMode(DW1000.MODE_LONGDATA_RANGE_ACCURACY);
+  DW1000.commitConfiguration();
+  Serial.print(F("Send any character for a register snapshot of "));
+  Serial.print(DW1000.getRegisterSnapshotSize()); Serial.println(F(" bytes"));
+}
+
+void loop() {
+  if(Serial.available()) {
+    while(Serial.available()) {
+      Serial.read();
+    }
+    DW1000.writeRegisterSnapshot(Serial);
+  }
+}
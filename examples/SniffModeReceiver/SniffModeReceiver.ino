@@ -0,0 +1,140 @@
+/*
+ * Decawave DW1000 library for arduino.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file SniffModeReceiver.ino
+ * Measurement harness for the low duty-cycle SNIFF receive mode. Steps through
+ * a table of on/off settings and reports, per setting, the receiver duty-cycle
+ * and the share of BLINK and POLL frames that were detected. Use it together
+ * with the "SniffModeSender" example sketch to pick the cheapest setting that
+ * still catches every frame.
+ */
+#include <SPI.h>
+#include <DW1000.h>
+
+// connection pins
+const uint8_t PIN_RST = 9; // reset pin
+const uint8_t PIN_IRQ = 2; // irq pin
+const uint8_t PIN_SS = SS; // spi select pin
+
+// duration of one measurement window per setting [ms]
+const uint32_t WINDOW = 10000;
+// PAC size [symbols] and symbol duration [ns] of MODE_LONGDATA_RANGE_LOWPOWER
+const uint16_t PAC_SYMBOLS = 64;
+const uint16_t SYMBOL_NS = 994;
+// settings to measure: on-time [PACs] and off-time [us] (off-time 0 is full receive)
+const uint8_t NUM_SETTINGS = 8;
+const byte SNIFF_SETTINGS[NUM_SETTINGS][2] = {
+  {1, 0}, {1, 32}, {1, 64}, {2, 64}, {1, 128}, {2, 128}, {1, 255}, {4, 255}
+};
+
+volatile boolean received = false;
+uint8_t setting = 0;
+uint32_t windowStart = 0;
+// detection statistics of the current window
+uint16_t numBlink = 0;
+uint16_t numPoll = 0;
+uint16_t firstSeq = 0;
+uint16_t lastSeq = 0;
+boolean anySeq = false;
+byte frame[16];
+
+void setup() {
+  Serial.begin(115200);
+  Serial.println(F("### DW1000-arduino-sniff-receiver ###"));
+  // initialize the driver
+  DW1000.begin(PIN_IRQ, PIN_RST);
+  DW1000.select(PIN_SS);
+  // general configuration, same mode as the sender
+  DW1000.newConfiguration();
+  DW1000.setDefaults();
+  DW1000.setDeviceAddress(6);
+  DW1000.setNetworkId(10);
+  DW1000.enableMode(DW1000.MODE_LONGDATA_RANGE_LOWPOWER);
+  DW1000.commitConfiguration();
+  DW1000.attachReceivedHandler(handleReceived);
+  Serial.println(F("on[PAC]\toff[us]\tduty[%]\tblink[%]\tpoll[%]"));
+  startWindow();
+}
+
+void handleReceived() {
+  received = true;
+}
+
+void startWindow() {
+  DW1000.newReceive();
+  DW1000.setDefaults();
+  DW1000.setSniffMode(SNIFF_SETTINGS[setting][0], SNIFF_SETTINGS[setting][1]);
+  DW1000.receivePermanently(true);
+  DW1000.startReceive();
+  numBlink = 0;
+  numPoll = 0;
+  anySeq = false;
+  windowStart = millis();
+}
+
+float dutyCycle(byte onTimePacs, byte offTimeUs) {
+  if(offTimeUs == 0) {
+    return 100.0f;
+  }
+  // the chip adds one PAC to the on-time, the off-time counts in 128 system clock cycles
+  float onUs = (onTimePacs + 1) * PAC_SYMBOLS * SYMBOL_NS * 1.0e-3f;
+  float offUs = offTimeUs * 1.0256f;
+  return 100.0f * onUs / (onUs + offUs);
+}
+
+void reportWindow() {
+  // frames the sender emitted while we listened, even sequence numbers are BLINKs
+  uint16_t expected = anySeq ? lastSeq - firstSeq + 1 : 0;
+  uint16_t expectedBlink = expected / 2;
+  uint16_t expectedPoll = expected / 2;
+  if(expected % 2 != 0) {
+    if(firstSeq % 2 == 0) {
+      expectedBlink++;
+    } else {
+      expectedPoll++;
+    }
+  }
+  Serial.print(SNIFF_SETTINGS[setting][0]); Serial.print("\t");
+  Serial.print(SNIFF_SETTINGS[setting][1]); Serial.print("\t");
+  Serial.print(dutyCycle(SNIFF_SETTINGS[setting][0], SNIFF_SETTINGS[setting][1]), 1); Serial.print("\t");
+  Serial.print(expectedBlink > 0 ? 100.0f * numBlink / expectedBlink : 0.0f, 1); Serial.print("\t");
+  Serial.println(expectedPoll > 0 ? 100.0f * numPoll / expectedPoll : 0.0f, 1);
+}
+
+void loop() {
+  if(received) {
+    received = false;
+    uint16_t len = DW1000.getDataLength();
+    if(len >= 2 && len <= sizeof(frame)) {
+      DW1000.getData(frame, len);
+      uint16_t seq = frame[len - 2] | ((uint16_t)frame[len - 1] << 8);
+      if(!anySeq) {
+        firstSeq = seq;
+        anySeq = true;
+      }
+      lastSeq = seq;
+      if(frame[0] == 0xC5) {
+        numBlink++;
+      } else {
+        numPoll++;
+      }
+    }
+  }
+  if(millis() - windowStart > WINDOW) {
+    reportWindow();
+    setting = (setting + 1) % NUM_SETTINGS;
+    startWindow();
+  }
+}
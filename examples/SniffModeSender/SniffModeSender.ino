@@ -0,0 +1,96 @@
+/*
+ * Decawave DW1000 library for arduino.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file SniffModeSender.ino
+ * Sends BLINK and POLL shaped frames (same length as the ones of DW1000Ranging)
+ * in turns at a fixed interval, each carrying a sequence number. Complements the
+ * "SniffModeReceiver" example sketch, which measures the frame detection rate
+ * against the SNIFF duty-cycle.
+ */
+#include <SPI.h>
+#include <DW1000.h>
+
+// connection pins
+const uint8_t PIN_RST = 9; // reset pin
+const uint8_t PIN_IRQ = 2; // irq pin
+const uint8_t PIN_SS = SS; // spi select pin
+
+// interval between two frames [ms], has to match the receiver sketch
+const uint16_t SEND_INTERVAL = 20;
+// frame lengths of BLINK and POLL (for one anchor) frames of DW1000Ranging
+const uint8_t LEN_BLINK = 12;
+const uint8_t LEN_POLL = 15;
+
+volatile boolean sentAck = false;
+uint16_t seqNum = 0;
+uint32_t lastSent = 0;
+byte frame[LEN_POLL];
+
+void setup() {
+  Serial.begin(115200);
+  Serial.println(F("### DW1000-arduino-sniff-sender ###"));
+  // initialize the driver
+  DW1000.begin(PIN_IRQ, PIN_RST);
+  DW1000.select(PIN_SS);
+  // general configuration, same mode as the receiver
+  DW1000.newConfiguration();
+  DW1000.setDefaults();
+  DW1000.setDeviceAddress(5);
+  DW1000.setNetworkId(10);
+  DW1000.enableMode(DW1000.MODE_LONGDATA_RANGE_LOWPOWER);
+  DW1000.commitConfiguration();
+  char msg[128];
+  DW1000.getPrintableDeviceMode(msg);
+  Serial.print(F("Device mode: ")); Serial.println(msg);
+  DW1000.attachSentHandler(handleSent);
+  sentAck = true;
+}
+
+void handleSent() {
+  sentAck = true;
+}
+
+void transmitter() {
+  // even sequence numbers are BLINK, odd ones are POLL shaped frames
+  uint8_t len;
+  memset(frame, 0, LEN_POLL);
+  if(seqNum % 2 == 0) {
+    frame[0] = 0xC5;
+    len = LEN_BLINK;
+  } else {
+    frame[0] = 0x41;
+    frame[1] = 0x88;
+    len = LEN_POLL;
+  }
+  frame[len - 2] = (byte)(seqNum & 0xFF);
+  frame[len - 1] = (byte)(seqNum >> 8);
+  DW1000.newTransmit();
+  DW1000.setDefaults();
+  DW1000.setData(frame, len);
+  DW1000.startTransmit();
+}
+
+void loop() {
+  if(!sentAck || millis() - lastSent < SEND_INTERVAL) {
+    return;
+  }
+  sentAck = false;
+  lastSent = millis();
+  transmitter();
+  seqNum++;
+  if(seqNum % 500 == 0) {
+    Serial.print(F("Sent frames: ")); Serial.println(seqNum);
+  }
+}
@@ -0,0 +1,100 @@
+/*
+ * Decawave DW1000 library for arduino.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file TestModeSender.ino
+ * Puts the DW1000 into continuous frame or continuous wave test mode, e.g. for
+ * regulatory and range tests. Complements the "ThroughputReceiver" example sketch.
+ *
+ * Serial commands:
+ *  - '0' to '5' select the mode of operation (see MODES below)
+ *  - 'f' starts continuous frame mode (one frame every FRAME_PERIOD)
+ *  - 'w' starts continuous wave mode
+ *  - 's' stops the test mode
+ */
+#include <SPI.h>
+#include <DW1000.h>
+
+// connection pins
+const uint8_t PIN_RST = 9; // reset pin
+const uint8_t PIN_IRQ = 2; // irq pin
+const uint8_t PIN_SS = SS; // spi select pin
+
+// frame start to frame start period in units of ~8 ns (124800 is 1 ms), same as on the receiver
+const uint32_t FRAME_PERIOD = 124800;
+// frame payload length (without the 2 bytes checksum), same as on the receiver
+const uint16_t PAYLOAD_LEN = 20;
+
+const byte* const MODES[] = {
+  DW1000.MODE_LONGDATA_RANGE_LOWPOWER,
+  DW1000.MODE_SHORTDATA_FAST_LOWPOWER,
+  DW1000.MODE_LONGDATA_FAST_LOWPOWER,
+  DW1000.MODE_SHORTDATA_FAST_ACCURACY,
+  DW1000.MODE_LONGDATA_FAST_ACCURACY,
+  DW1000.MODE_LONGDATA_RANGE_ACCURACY
+};
+const uint8_t NUM_MODES = sizeof(MODES) / sizeof(MODES[0]);
+
+uint8_t mode = 0;
+byte payload[PAYLOAD_LEN];
+
+void setup() {
+  Serial.begin(115200);
+  Serial.println(F("### DW1000-arduino-test-mode-sender ###"));
+  // initialize the driver
+  DW1000.begin(PIN_IRQ, PIN_RST);
+  DW1000.select(PIN_SS);
+  for(uint16_t i = 0; i < PAYLOAD_LEN; i++) {
+    payload[i] = (byte)i;
+  }
+  configure();
+}
+
+void configure() {
+  DW1000.newConfiguration();
+  DW1000.setDefaults();
+  DW1000.setDeviceAddress(5);
+  DW1000.setNetworkId(10);
+  DW1000.enableMode(MODES[mode]);
+  DW1000.commitConfiguration();
+  char msg[128];
+  DW1000.getPrintableDeviceMode(msg);
+  Serial.print(F("Mode ")); Serial.print(mode); Serial.print(F(": ")); Serial.println(msg);
+}
+
+void loop() {
+  if(!Serial.available()) {
+    return;
+  }
+  char cmd = Serial.read();
+  if(cmd >= '0' && cmd < '0' + NUM_MODES) {
+    DW1000.stopTestMode();
+    mode = cmd - '0';
+    configure();
+  } else if(cmd == 'f') {
+    DW1000.stopTestMode();
+    DW1000.newTransmit();
+    DW1000.setDefaults();
+    DW1000.setData(payload, PAYLOAD_LEN);
+    DW1000.startContinuousFrame(FRAME_PERIOD);
+    Serial.println(F("Continuous frame mode"));
+  } else if(cmd == 'w') {
+    DW1000.stopTestMode();
+    DW1000.startContinuousWave();
+    Serial.println(F("Continuous wave mode"));
+  } else if(cmd == 's') {
+    DW1000.stopTestMode();
+    Serial.println(F("Stopped"));
+  }
+}
@@ -0,0 +1,188 @@
+/*
+ * Decawave DW1000 library for arduino.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file ThroughputReceiver.ino
+ * Receiver side harness for the continuous frame test mode of the "TestModeSender"
+ * example sketch. Reports, per measurement window, packets per second, packet error
+ * rate, a histogram of the receive power and the achieved payload data rate versus
+ * the theoretical ceiling of the selected mode of operation.
+ *
+ * Serial commands:
+ *  - '0' to '5' select the mode of operation (must match the sender)
+ */
+#include <SPI.h>
+#include <DW1000.h>
+
+// connection pins
+const uint8_t PIN_RST = 9; // reset pin
+const uint8_t PIN_IRQ = 2; // irq pin
+const uint8_t PIN_SS = SS; // spi select pin
+
+// same as on the sender
+const uint32_t FRAME_PERIOD = 124800;
+const uint16_t PAYLOAD_LEN = 20;
+// measurement window [ms]
+const uint32_t WINDOW = 5000;
+// receive power histogram, HIST_BINS bins of HIST_STEP dBm below HIST_TOP dBm
+const uint8_t HIST_BINS = 10;
+const int8_t HIST_TOP = -60;
+const uint8_t HIST_STEP = 4;
+
+const byte* const MODES[] = {
+  DW1000.MODE_LONGDATA_RANGE_LOWPOWER,
+  DW1000.MODE_SHORTDATA_FAST_LOWPOWER,
+  DW1000.MODE_LONGDATA_FAST_LOWPOWER,
+  DW1000.MODE_SHORTDATA_FAST_ACCURACY,
+  DW1000.MODE_LONGDATA_FAST_ACCURACY,
+  DW1000.MODE_LONGDATA_RANGE_ACCURACY
+};
+const uint8_t NUM_MODES = sizeof(MODES) / sizeof(MODES[0]);
+
+volatile uint16_t numReceived = 0;
+volatile uint16_t numFailed = 0;
+volatile boolean received = false;
+uint8_t mode = 0;
+uint32_t windowStart = 0;
+uint16_t histogram[HIST_BINS];
+// theoretical frame duration of the current mode [us]
+float frameDuration = 0;
+
+void setup() {
+  Serial.begin(115200);
+  Serial.println(F("### DW1000-arduino-throughput-receiver ###"));
+  // initialize the driver
+  DW1000.begin(PIN_IRQ, PIN_RST);
+  DW1000.select(PIN_SS);
+  DW1000.attachReceivedHandler(handleReceived);
+  DW1000.attachReceiveFailedHandler(handleReceiveFailed);
+  configure();
+}
+
+void handleReceived() {
+  numReceived++;
+  received = true;
+}
+
+void handleReceiveFailed() {
+  numFailed++;
+}
+
+// duration of a frame on air, see DW1000 user manual, chapter 3 (message transmission)
+float computeFrameDuration(const byte mode[], uint16_t payloadLen) {
+  float symbol = (mode[1] == DW1000.TX_PULSE_FREQ_16MHZ ? 0.99359f : 1.01763f);
+  uint16_t preamble;
+  if(mode[2] == DW1000.TX_PREAMBLE_LEN_2048) {
+    preamble = 2048;
+  } else if(mode[2] == DW1000.TX_PREAMBLE_LEN_1024) {
+    preamble = 1024;
+  } else {
+    preamble = 128;
+  }
+  float bit;
+  float phrBit;
+  uint8_t sfd;
+  if(mode[0] == DW1000.TRX_RATE_110KBPS) {
+    bit = phrBit = 8.20513f;
+    sfd = 64;
+  } else {
+    bit = (mode[0] == DW1000.TRX_RATE_850KBPS ? 1.02564f : 0.12821f);
+    phrBit = 1.02564f;
+    sfd = 8;
+  }
+  // payload with checksum and 48 Reed-Solomon parity bits per 330 data bits
+  uint32_t bits = (payloadLen + 2) * 8;
+  bits += ((bits + 329) / 330) * 48;
+  return (preamble + sfd) * symbol + 21 * phrBit + bits * bit;
+}
+
+void configure() {
+  DW1000.newConfiguration();
+  DW1000.setDefaults();
+  DW1000.setDeviceAddress(6);
+  DW1000.setNetworkId(10);
+  DW1000.enableMode(MODES[mode]);
+  DW1000.commitConfiguration();
+  frameDuration = computeFrameDuration(MODES[mode], PAYLOAD_LEN);
+  char msg[128];
+  DW1000.getPrintableDeviceMode(msg);
+  Serial.print(F("Mode ")); Serial.print(mode); Serial.print(F(": ")); Serial.println(msg);
+  Serial.print(F("Frame duration [us]: ")); Serial.println(frameDuration);
+  DW1000.newReceive();
+  DW1000.setDefaults();
+  DW1000.receivePermanently(true);
+  DW1000.startReceive();
+  startWindow();
+}
+
+void startWindow() {
+  noInterrupts();
+  numReceived = 0;
+  numFailed = 0;
+  interrupts();
+  memset(histogram, 0, sizeof(histogram));
+  windowStart = millis();
+}
+
+void report(uint32_t elapsed) {
+  noInterrupts();
+  uint16_t good = numReceived;
+  uint16_t failed = numFailed;
+  interrupts();
+  // frames are sent every FRAME_PERIOD, or back-to-back if they take longer
+  float period = FRAME_PERIOD * (1000.0f / 124800.0f);
+  if(period < frameDuration) {
+    period = frameDuration;
+  }
+  float expected = elapsed * 1000.0f / period;
+  float per = (expected > 0 ? 100.0f * (1.0f - good / expected) : 0.0f);
+  float achieved = good * PAYLOAD_LEN * 8.0f / elapsed;
+  float ceiling = PAYLOAD_LEN * 8.0f * 1000.0f / frameDuration;
+  Serial.print(F("pkts/s: ")); Serial.print(good * 1000.0f / elapsed, 1);
+  Serial.print(F(" failed: ")); Serial.print(failed);
+  Serial.print(F(" PER [%]: ")); Serial.print(per < 0 ? 0 : per, 2);
+  Serial.print(F(" payload rate [kb/s]: ")); Serial.print(achieved, 2);
+  Serial.print(F(" of max. ")); Serial.println(ceiling, 2);
+  for(uint8_t i = 0; i < HIST_BINS; i++) {
+    Serial.print(F("  ")); Serial.print(HIST_TOP - (int16_t)i * HIST_STEP);
+    Serial.print(F(" dBm: ")); Serial.println(histogram[i]);
+  }
+}
+
+void loop() {
+  if(Serial.available()) {
+    char cmd = Serial.read();
+    if(cmd >= '0' && cmd < '0' + NUM_MODES) {
+      mode = cmd - '0';
+      configure();
+    }
+  }
+  if(received) {
+    // at high frame rates not every frame can be sampled, the histogram shows the sampled ones
+    received = false;
+    float power = DW1000.getReceivePower();
+    int16_t bin = (int16_t)((HIST_TOP - power) / HIST_STEP);
+    if(bin < 0) {
+      bin = 0;
+    } else if(bin >= HIST_BINS) {
+      bin = HIST_BINS - 1;
+    }
+    histogram[bin]++;
+  }
+  uint32_t elapsed = millis() - windowStart;
+  if(elapsed >= WINDOW) {
+    report(elapsed);
+    startWindow();
+  }
+}
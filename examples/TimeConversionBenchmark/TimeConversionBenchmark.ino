@@ -0,0 +1,115 @@
+/*
+ * Decawave DW1000 library for arduino.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file TimeConversionBenchmark.ino
+ * Compares the integer time conversions of DW1000Time with the float ones:
+ * cycles per conversion and the largest error against the exact value.
+ * Needs no DW1000 module.
+ */
+
+#include <DW1000Time.h>
+
+const uint16_t ROUNDS = 1000;
+
+volatile int64_t sink; // keeps the compiler from removing the loops
+
+// exact references, in 64 bit integer arithmetic
+int64_t exactTicks(int32_t us) { return (int64_t)us * 319488 / 5; }
+int64_t exactMillimeters(int32_t ticks) { return ((int64_t)ticks * 149896229 + 15974400) / 31948800; }
+
+void track(int64_t& worst, int64_t value, int64_t exact) {
+  int64_t error = value > exact ? value - exact : exact - value;
+  if(error > worst) {
+    worst = error;
+  }
+}
+
+void report(const __FlashStringHelper* name, uint32_t floatUs, uint32_t intUs, int64_t floatError, int64_t intError) {
+  Serial.print(name);
+  Serial.print(F("\t float ")); Serial.print(floatUs * (F_CPU / 1000000L) / ROUNDS);
+  Serial.print(F(" cycles, error ")); Serial.print((long)floatError);
+  Serial.print(F("\t integer ")); Serial.print(intUs * (F_CPU / 1000000L) / ROUNDS);
+  Serial.print(F(" cycles, error ")); Serial.println((long)intError);
+}
+
+void setup() {
+  Serial.begin(115200);
+  Serial.println(F("### DW1000-arduino-time-conversion-benchmark ###"));
+  Serial.println(F("(cycles include the loop, errors in ticks resp. mm)"));
+  uint32_t start, floatUs, intUs;
+  int64_t floatError = 0, intError = 0;
+
+  // microseconds -> ticks, e.g. delayed transmit; large values are lossy with float (24 bit mantissa)
+  start = micros();
+  for(uint16_t i = 0; i < ROUNDS; i++) {
+    sink = (int64_t)((float)(i * 17000L) * DW1000Time::TIME_RES_INV);
+  }
+  floatUs = micros() - start;
+  start = micros();
+  for(uint16_t i = 0; i < ROUNDS; i++) {
+    sink = DW1000Time::microsecondsToTicks(i * 17000L);
+  }
+  intUs = micros() - start;
+  for(uint16_t i = 0; i < ROUNDS; i++) {
+    int32_t us = i * 17000L;
+    int64_t exact = exactTicks(us);
+    track(floatError, (int64_t)((float)us * DW1000Time::TIME_RES_INV), exact);
+    track(intError, DW1000Time::microsecondsToTicks(us), exact);
+  }
+  report(F("us -> ticks"), floatUs, intUs, floatError, intError);
+
+  // ticks -> millimeters, e.g. time of flight to range (up to about 1 km)
+  floatError = intError = 0;
+  start = micros();
+  for(uint16_t i = 0; i < ROUNDS; i++) {
+    sink = (int32_t)((float)(i * 213L) * DW1000Time::DISTANCE_OF_RADIO * 1000.0f + 0.5f);
+  }
+  floatUs = micros() - start;
+  start = micros();
+  for(uint16_t i = 0; i < ROUNDS; i++) {
+    sink = DW1000Time::ticksToMillimeters(i * 213L);
+  }
+  intUs = micros() - start;
+  for(uint16_t i = 0; i < ROUNDS; i++) {
+    int32_t ticks = i * 213L;
+    int64_t exact = exactMillimeters(ticks);
+    track(floatError, (int64_t)((float)ticks * DW1000Time::DISTANCE_OF_RADIO * 1000.0f + 0.5f), exact);
+    track(intError, (int64_t)DW1000Time::ticksToMillimeters(ticks), exact);
+  }
+  report(F("ticks -> mm"), floatUs, intUs, floatError, intError);
+
+  // ticks -> microseconds, e.g. printing timestamps (full 40 bit range)
+  floatError = intError = 0;
+  start = micros();
+  for(uint16_t i = 0; i < ROUNDS; i++) {
+    sink = (int32_t)((float)((int64_t)i * 1099511627LL) * DW1000Time::TIME_RES);
+  }
+  floatUs = micros() - start;
+  start = micros();
+  for(uint16_t i = 0; i < ROUNDS; i++) {
+    sink = DW1000Time::ticksToMicroseconds((int64_t)i * 1099511627LL);
+  }
+  intUs = micros() - start;
+  for(uint16_t i = 0; i < ROUNDS; i++) {
+    int64_t ticks = (int64_t)i * 1099511627LL;
+    int64_t exact = ticks * 5 / 319488;
+    track(floatError, (int64_t)((float)ticks * DW1000Time::TIME_RES), exact);
+    track(intError, (int64_t)DW1000Time::ticksToMicroseconds(ticks), exact);
+  }
+  report(F("ticks -> us"), floatUs, intUs, floatError, intError);
+}
+
+void loop() {
+}
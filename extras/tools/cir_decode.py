@@ -0,0 +1,145 @@
+#!/usr/bin/env python3
+#
+# Decawave DW1000 library for arduino.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+"""Decodes channel impulse response captures of the CIRCapture example sketch.
+
+Reads the binary Serial stream either from a capture file (e.g. recorded with
+`cat /dev/ttyUSB0 > capture.bin`) or live from a serial port (needs pyserial),
+and writes one CSV row per tap and/or a numpy .npz archive for offline analysis.
+
+    cir_decode.py capture.bin --csv cir.csv
+    cir_decode.py --port /dev/ttyUSB0 --baud 115200 --frames 100 --npz cir.npz
+"""
+
+import argparse
+import math
+import struct
+import sys
+
+MAGIC = b"CIR\x01"
+HEADER = struct.Struct("<HHHH")
+TRAILER = struct.Struct("<IH")
+TAP = 4
+
+
+class CirFrame(object):
+    def __init__(self, number, fp_index, first_tap, taps, readout_us):
+        self.number = number
+        # first path index is a 10.6 bit fixed point value
+        self.first_path = fp_index / 64.0
+        self.first_tap = first_tap
+        self.taps = taps  # list of (real, imag)
+        self.readout_us = readout_us
+
+    def magnitudes(self):
+        return [math.hypot(re, im) for re, im in self.taps]
+
+
+def decode(data):
+    """Returns all valid frames in data and the number of corrupted frames.
+    Unrelated bytes (e.g. text printed at boot) are skipped."""
+    frames = []
+    corrupted = 0
+    pos = 0
+    while True:
+        pos = data.find(MAGIC, pos)
+        if pos < 0 or pos + len(MAGIC) + HEADER.size > len(data):
+            break
+        start = pos + len(MAGIC)
+        number, fp_index, first_tap, num_taps = HEADER.unpack_from(data, start)
+        payload = start + HEADER.size
+        end = payload + num_taps * TAP + TRAILER.size
+        if end > len(data):
+            break
+        readout_us, checksum = TRAILER.unpack_from(data, end - TRAILER.size)
+        if sum(data[start:end - 2]) & 0xFFFF != checksum:
+            corrupted += 1
+            pos += 1
+            continue
+        taps = list(struct.iter_unpack("<hh", data[payload:payload + num_taps * TAP]))
+        frames.append(CirFrame(number, fp_index, first_tap, taps, readout_us))
+        pos = end
+    return frames, corrupted
+
+
+def read_port(port, baud, num_frames):
+    import serial
+    data = bytearray()
+    with serial.Serial(port, baud, timeout=1) as line:
+        while True:
+            data += line.read(4096)
+            frames, _ = decode(bytes(data))
+            if len(frames) >= num_frames:
+                return bytes(data)
+
+
+def write_csv(frames, path):
+    with open(path, "w") as out:
+        out.write("frame,tap,real,imag,magnitude,first_path\n")
+        for frame in frames:
+            for i, (re, im) in enumerate(frame.taps):
+                out.write("%d,%d,%d,%d,%.1f,%.3f\n" % (frame.number, frame.first_tap + i, re, im,
+                                                       math.hypot(re, im), frame.first_path))
+
+
+def write_npz(frames, path):
+    import numpy as np
+    width = max(len(frame.taps) for frame in frames)
+    cir = np.zeros((len(frames), width), dtype=np.complex64)
+    for row, frame in enumerate(frames):
+        cir[row, :len(frame.taps)] = [complex(re, im) for re, im in frame.taps]
+    np.savez(path, cir=cir,
+             frame=np.array([f.number for f in frames]),
+             first_tap=np.array([f.first_tap for f in frames]),
+             first_path=np.array([f.first_path for f in frames]),
+             readout_us=np.array([f.readout_us for f in frames]))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("capture", nargs="?", help="binary capture file")
+    parser.add_argument("--port", help="read live from this serial port instead")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--frames", type=int, default=100, help="frames to read from the port")
+    parser.add_argument("--csv", help="write taps as CSV")
+    parser.add_argument("--npz", help="write taps as numpy archive (complex array frames x taps)")
+    args = parser.parse_args()
+
+    if args.port:
+        data = read_port(args.port, args.baud, args.frames)
+    elif args.capture:
+        with open(args.capture, "rb") as capture:
+            data = capture.read()
+    else:
+        parser.error("either a capture file or --port is required")
+
+    frames, corrupted = decode(data)
+    if not frames:
+        sys.exit("no CIR frames found")
+    if args.csv:
+        write_csv(frames, args.csv)
+    if args.npz:
+        write_npz(frames, args.npz)
+
+    readout = sorted(f.readout_us for f in frames)
+    taps = sum(len(f.taps) for f in frames) / float(len(frames))
+    print("frames: %d (%d corrupted), taps/frame: %.0f" % (len(frames), corrupted, taps))
+    print("readout time [us]: min %d, median %d, max %d -> max. %.1f captures/s (without Serial)"
+          % (readout[0], readout[len(readout) // 2], readout[-1], 1e6 / readout[len(readout) // 2]))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,343 @@
+#!/usr/bin/env python3
+#
+# Decawave DW1000 library for arduino.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+"""Decodes and compares DW1000 register snapshots (DW1000Class::writeRegisterSnapshot()).
+
+With one snapshot all registers are printed field by field, with two snapshots
+only the differences. Snapshots are read from capture files or live from a
+serial port (needs pyserial, the RegisterSnapshot example sends one per
+received character).
+
+    reg_diff.py node1.bin                     # decode
+    reg_diff.py node1.bin node2.bin           # diff
+    reg_diff.py --port /dev/ttyUSB0 --save node1.bin
+"""
+
+import argparse
+import struct
+import sys
+
+MAGIC = b"REG\x01"
+BLOCK = struct.Struct("<BHH")
+
+# sub-registers per register file (user manual chapter 7):
+#   file: (name, volatile, {offset: (name, length, volatile, [(field, lsb, width), ...])})
+# volatile registers change while the chip runs and are skipped by the diff unless --all is given
+EVENTS = [("IRQS", 0, 1), ("CPLOCK", 1, 1), ("ESYNCR", 2, 1), ("AAT", 3, 1), ("TXFRB", 4, 1),
+          ("TXPRS", 5, 1), ("TXPHS", 6, 1), ("TXFRS", 7, 1), ("RXPRD", 8, 1), ("RXSFDD", 9, 1),
+          ("LDEDONE", 10, 1), ("RXPHD", 11, 1), ("RXPHE", 12, 1), ("RXDFR", 13, 1), ("RXFCG", 14, 1),
+          ("RXFCE", 15, 1), ("RXRFSL", 16, 1), ("RXRFTO", 17, 1), ("LDEERR", 18, 1), ("RXOVRR", 20, 1),
+          ("RXPTO", 21, 1), ("GPIOIRQ", 22, 1), ("SLP2INIT", 23, 1), ("RFPLL_LL", 24, 1),
+          ("CLKPLL_LL", 25, 1), ("RXSFDTO", 26, 1), ("HPDWARN", 27, 1), ("TXBERR", 28, 1),
+          ("AFFREJ", 29, 1), ("HSRBP", 30, 1), ("ICRBP", 31, 1)]
+
+REGISTERS = {
+    0x00: ("DEV_ID", False, {0x00: ("DEV_ID", 4, False, [("REV", 0, 4), ("VER", 4, 4), ("MODEL", 8, 8),
+                                                           ("RIDTAG", 16, 16)])}),
+    0x01: ("EUI", False, {0x00: ("EUI", 8, False, [])}),
+    0x03: ("PANADR", False, {0x00: ("PANADR", 4, False, [("SHORT_ADDR", 0, 16), ("PAN_ID", 16, 16)])}),
+    0x04: ("SYS_CFG", False, {0x00: ("SYS_CFG", 4, False, [
+        ("FFEN", 0, 1), ("FFBC", 1, 1), ("FFAB", 2, 1), ("FFAD", 3, 1), ("FFAA", 4, 1), ("FFAM", 5, 1),
+        ("FFAR", 6, 1), ("FFA4", 7, 1), ("FFA5", 8, 1), ("HIRQ_POL", 9, 1), ("SPI_EDGE", 10, 1),
+        ("DIS_FCE", 11, 1), ("DIS_DRXB", 12, 1), ("DIS_PHE", 13, 1), ("DIS_RSDE", 14, 1),
+        ("FCS_INIT2F", 15, 1), ("PHR_MODE", 16, 2), ("DIS_STXP", 18, 1), ("RXM110K", 22, 1),
+        ("RXWTOE", 28, 1), ("RXAUTR", 29, 1), ("AUTOACK", 30, 1), ("AACKPEND", 31, 1)])}),
+    0x06: ("SYS_TIME", True, {0x00: ("SYS_TIME", 5, True, [])}),
+    0x08: ("TX_FCTRL", False, {0x00: ("TX_FCTRL", 5, False, [
+        ("TFLEN", 0, 7), ("TFLE", 7, 3), ("TXBR", 13, 2), ("TR", 15, 1), ("TXPRF", 16, 2), ("TXPSR", 18, 2),
+        ("PE", 20, 2), ("TXBOFFS", 22, 10), ("IFSDELAY", 32, 8)])}),
+    0x0A: ("DX_TIME", False, {0x00: ("DX_TIME", 5, False, [])}),
+    0x0C: ("RX_FWTO", False, {0x00: ("RX_FWTO", 2, False, [])}),
+    0x0D: ("SYS_CTRL", False, {0x00: ("SYS_CTRL", 4, False, [
+        ("SFCST", 0, 1), ("TXSTRT", 1, 1), ("TXDLYS", 2, 1), ("CANSFCS", 3, 1), ("TRXOFF", 6, 1),
+        ("WAIT4RESP", 7, 1), ("RXENAB", 8, 1), ("RXDLYE", 9, 1), ("HRBPT", 24, 1)])}),
+    0x0E: ("SYS_MASK", False, {0x00: ("SYS_MASK", 4, False, [("M" + n, b, w) for n, b, w in EVENTS])}),
+    0x0F: ("SYS_STATUS", True, {0x00: ("SYS_STATUS", 5, True, EVENTS + [
+        ("RXRSCS", 32, 1), ("RXPREJ", 33, 1), ("TXPUTE", 34, 1)])}),
+    0x10: ("RX_FINFO", True, {0x00: ("RX_FINFO", 4, True, [
+        ("RXFLEN", 0, 7), ("RXFLE", 7, 3), ("RXNSPL", 11, 2), ("RXBR", 13, 2), ("RNG", 15, 1),
+        ("RXPRFR", 16, 2), ("RXPSR", 18, 2), ("RXPACC", 20, 12)])}),
+    0x12: ("RX_FQUAL", True, {0x00: ("RX_FQUAL", 8, True, [
+        ("STD_NOISE", 0, 16), ("FP_AMPL2", 16, 16), ("FP_AMPL3", 32, 16), ("CIR_PWR", 48, 16)])}),
+    0x13: ("RX_TTCKI", True, {0x00: ("RX_TTCKI", 4, True, [])}),
+    0x14: ("RX_TTCKO", True, {0x00: ("RX_TTCKO", 5, True, [("RXTOFS", 0, 19), ("RSMPDEL", 24, 8),
+                                                             ("RCPHASE", 32, 7)])}),
+    0x15: ("RX_TIME", True, {0x00: ("RX_TIME", 14, True, [
+        ("RX_STAMP", 0, 40), ("FP_INDEX", 40, 16), ("FP_AMPL1", 56, 16), ("RX_RAWST", 72, 40)])}),
+    0x17: ("TX_TIME", True, {0x00: ("TX_TIME", 10, True, [("TX_STAMP", 0, 40), ("TX_RAWST", 40, 40)])}),
+    0x18: ("TX_ANTD", False, {0x00: ("TX_ANTD", 2, False, [])}),
+    0x19: ("SYS_STATE", True, {0x00: ("SYS_STATE", 5, True, [("TX_STATE", 0, 4), ("RX_STATE", 8, 5),
+                                                               ("PMSC_STATE", 16, 4)])}),
+    0x1A: ("ACK_RESP_T", False, {0x00: ("ACK_RESP_T", 4, False, [("W4R_TIM", 0, 20), ("ACK_TIM", 24, 8)])}),
+    0x1D: ("RX_SNIFF", False, {0x00: ("RX_SNIFF", 4, False, [("SNIFF_ONT", 0, 4), ("SNIFF_OFFT", 8, 8)])}),
+    0x1E: ("TX_POWER", False, {0x00: ("TX_POWER", 4, False, [
+        ("BOOSTNORM", 0, 8), ("BOOSTP500", 8, 8), ("BOOSTP250", 16, 8), ("BOOSTP125", 24, 8)])}),
+    0x1F: ("CHAN_CTRL", False, {0x00: ("CHAN_CTRL", 4, False, [
+        ("TX_CHAN", 0, 4), ("RX_CHAN", 4, 4), ("DWSFD", 17, 1), ("RXPRF", 18, 2), ("TNSSFD", 20, 1),
+        ("RNSSFD", 21, 1), ("TX_PCODE", 22, 5), ("RX_PCODE", 27, 5)])}),
+    0x21: ("USR_SFD", False, {0x00: ("SFD_LENGTH", 1, False, [])}),
+    0x23: ("AGC_CTRL", False, {0x02: ("AGC_CTRL1", 2, False, [("DIS_AM", 0, 1)]),
+                               0x04: ("AGC_TUNE1", 2, False, []),
+                               0x0C: ("AGC_TUNE2", 4, False, []),
+                               0x12: ("AGC_TUNE3", 2, False, []),
+                               0x1E: ("AGC_STAT1", 3, True, [("EDG1", 6, 5), ("EDV2", 11, 9)])}),
+    0x24: ("EXT_SYNC", False, {0x00: ("EC_CTRL", 4, False, [("OSTSM", 0, 1), ("OSRSM", 1, 1), ("PLLLDT", 2, 1),
+                                                            ("WAIT", 3, 8), ("OSTRM", 11, 1)]),
+                               0x04: ("EC_RXTC", 4, True, []),
+                               0x08: ("EC_GOLP", 4, True, [])}),
+    0x26: ("GPIO_CTRL", False, {0x00: ("GPIO_MODE", 4, False, [("MSGP%d" % i, 6 + 2 * i, 2) for i in range(9)]),
+                                0x08: ("GPIO_DIR", 4, False, []),
+                                0x0C: ("GPIO_DOUT", 4, False, []),
+                                0x10: ("GPIO_IRQE", 4, False, []),
+                                0x28: ("GPIO_RAW", 4, True, [])}),
+    0x27: ("DRX_CONF", False, {0x02: ("DRX_TUNE0b", 2, False, []),
+                               0x04: ("DRX_TUNE1a", 2, False, []),
+                               0x06: ("DRX_TUNE1b", 2, False, []),
+                               0x08: ("DRX_TUNE2", 4, False, []),
+                               0x20: ("DRX_SFDTOC", 2, False, []),
+                               0x24: ("DRX_PRETOC", 2, False, []),
+                               0x26: ("DRX_TUNE4H", 2, False, []),
+                               0x28: ("DRX_CAR_INT", 3, True, [])}),
+    0x28: ("RF_CONF", False, {0x00: ("RF_CONF", 4, False, [("TXFEN", 8, 5), ("PLLFEN", 13, 3), ("LDOFEN", 16, 5),
+                                                           ("TXRXSW", 21, 2)]),
+                              0x0B: ("RF_RXCTRLH", 1, False, []),
+                              0x0C: ("RF_TXCTRL", 4, False, [("TXMTUNE", 5, 4), ("TXMQ", 9, 3)]),
+                              0x2C: ("RF_STATUS", 4, True, [("CPLLLOCK", 0, 1), ("CPLLLOW", 1, 1),
+                                                            ("CPLLHIGH", 2, 1), ("RFPLLLOCK", 3, 1)]),
+                              0x30: ("LDOTUNE", 5, False, [])}),
+    0x2A: ("TX_CAL", False, {0x00: ("TC_SARC", 2, False, [("SAR_CTRL", 0, 1)]),
+                             0x03: ("TC_SARL", 3, True, [("SAR_LVBAT", 0, 8), ("SAR_LTEMP", 8, 8)]),
+                             0x06: ("TC_SARW", 2, False, [("SAR_WVBAT", 0, 8), ("SAR_WTEMP", 8, 8)]),
+                             0x08: ("TC_PG_CTRL", 1, False, []),
+                             0x09: ("TC_PG_STATUS", 2, True, []),
+                             0x0B: ("TC_PGDELAY", 1, False, []),
+                             0x0C: ("TC_PGTEST", 1, False, [])}),
+    0x2B: ("FS_CTRL", False, {0x07: ("FS_PLLCFG", 4, False, []),
+                              0x0B: ("FS_PLLTUNE", 1, False, []),
+                              0x0E: ("FS_XTALT", 1, False, [("XTALT", 0, 5)])}),
+    0x2C: ("AON", False, {0x00: ("AON_WCFG", 2, False, [("ONW_RADC", 0, 1), ("ONW_RX", 1, 1), ("ONW_LEUI", 3, 1),
+                                                        ("ONW_LDC", 6, 1), ("ONW_L64P", 7, 1), ("PRES_SLEEP", 8, 1),
+                                                        ("ONW_LLDE", 11, 1), ("ONW_LLDO", 12, 1)]),
+                          0x02: ("AON_CTRL", 1, False, []),
+                          0x03: ("AON_RDAT", 1, True, []),
+                          0x04: ("AON_ADDR", 1, False, []),
+                          0x06: ("AON_CFG0", 4, False, [("SLEEP_EN", 0, 1), ("WAKE_PIN", 1, 1), ("WAKE_SPI", 2, 1),
+                                                        ("WAKE_CNT", 3, 1), ("LPDIV_EN", 4, 1), ("LPCLKDIVA", 5, 11),
+                                                        ("SLEEP_TIM", 16, 16)]),
+                          0x0A: ("AON_CFG1", 2, False, [("SLEEP_CE", 0, 1), ("SMXX", 1, 1), ("LPOSC_C", 2, 1)])}),
+    0x2D: ("OTP_IF", False, {0x00: ("OTP_WDAT", 4, False, []),
+                             0x04: ("OTP_ADDR", 2, False, []),
+                             0x06: ("OTP_CTRL", 2, False, []),
+                             0x08: ("OTP_STAT", 2, True, []),
+                             0x0A: ("OTP_RDAT", 4, True, []),
+                             0x0E: ("OTP_SRDAT", 4, True, []),
+                             0x12: ("OTP_SF", 1, False, [("OPS_KICK", 0, 1), ("LDO_KICK", 1, 1),
+                                                         ("OPS_SEL", 5, 2)])}),
+    0x2E: ("LDE_IF", False, {0x0000: ("LDE_THRESH", 2, True, []),
+                             0x0806: ("LDE_CFG1", 1, False, [("NTM", 0, 5), ("PMULT", 5, 3)]),
+                             0x1000: ("LDE_PPINDX", 2, True, []),
+                             0x1002: ("LDE_PPAMPL", 2, True, []),
+                             0x1804: ("LDE_RXANTD", 2, False, []),
+                             0x1806: ("LDE_CFG2", 2, False, []),
+                             0x2804: ("LDE_REPC", 2, False, [])}),
+    0x2F: ("DIG_DIAG", False, dict([(0x00, ("EVC_CTRL", 4, False, [("EVC_EN", 0, 1), ("EVC_CLR", 1, 1)]))] +
+                                   [(0x04 + 2 * i, (name, 2, True, [])) for i, name in enumerate(
+                                       ["EVC_PHE", "EVC_RSE", "EVC_FCG", "EVC_FCE", "EVC_FFR", "EVC_OVR",
+                                        "EVC_STO", "EVC_PTO", "EVC_FWTO", "EVC_TXFS", "EVC_HPW", "EVC_TPW"])] +
+                                   [(0x24, ("DIAG_TMC", 2, False, [("TX_PSTM", 4, 1)]))])),
+    0x36: ("PMSC", False, {0x00: ("PMSC_CTRL0", 4, False, [("SYSCLKS", 0, 2), ("RXCLKS", 2, 2), ("TXCLKS", 4, 2),
+                                                           ("FACE", 6, 1), ("ADCCE", 10, 1), ("AMCE", 15, 1),
+                                                           ("GPCE", 16, 1), ("GPRN", 17, 1), ("GPDCE", 18, 1),
+                                                           ("GPDRN", 19, 1), ("KHZCLKEN", 23, 1),
+                                                           ("SOFTRESET", 28, 4)]),
+                           0x04: ("PMSC_CTRL1", 4, False, [("ARX2INIT", 1, 1), ("PKTSEQ", 3, 8), ("ATXSLP", 11, 1),
+                                                           ("ARXSLP", 12, 1), ("SNOZE", 13, 1), ("SNOZR", 14, 1),
+                                                           ("PLLSYN", 15, 1), ("LDERUNE", 17, 1),
+                                                           ("KHZCLKDIV", 26, 6)]),
+                           0x0C: ("PMSC_SNOZT", 1, False, []),
+                           0x26: ("PMSC_TXFSEQ", 2, False, []),
+                           0x28: ("PMSC_LEDC", 4, False, [("BLINK_TIM", 0, 8), ("BLNKEN", 8, 1),
+                                                          ("BLNKNOW", 16, 4)])}),
+}
+
+
+class Snapshot(object):
+    def __init__(self, blocks):
+        # (file, offset) -> bytes
+        self.blocks = blocks
+
+    def byte(self, register, address):
+        """Byte at address in a register file, None if it has not been read."""
+        for (file, offset), data in self.blocks.items():
+            if file == register and offset <= address < offset + len(data):
+                return data[address - offset]
+        return None
+
+    def value(self, register, offset, length):
+        data = [self.byte(register, offset + i) for i in range(length)]
+        if None in data:
+            return None
+        return int.from_bytes(bytes(data), "little")
+
+
+def decode(data):
+    """Returns all valid snapshots in data and the number of corrupted ones.
+    Unrelated bytes (e.g. text printed at boot) are skipped."""
+    snapshots = []
+    corrupted = 0
+    pos = 0
+    while True:
+        pos = data.find(MAGIC, pos)
+        if pos < 0 or pos + len(MAGIC) + 2 > len(data):
+            break
+        start = pos + len(MAGIC)
+        num_blocks, = struct.unpack_from("<H", data, start)
+        blocks = {}
+        end = start + 2
+        for _ in range(num_blocks):
+            if end + BLOCK.size > len(data):
+                end = None
+                break
+            file, offset, length = BLOCK.unpack_from(data, end)
+            end += BLOCK.size
+            blocks[(file, offset)] = data[end:end + length]
+            end += length
+        if end is None or end + 2 > len(data):
+            break
+        checksum, = struct.unpack_from("<H", data, end)
+        if crc16(data[start:end]) != checksum:
+            corrupted += 1
+            pos += 1
+            continue
+        snapshots.append(Snapshot(blocks))
+        pos = end + 2
+    return snapshots, corrupted
+
+
+def crc16(data, crc=0xFFFF):
+    # CRC-16/CCITT, same as DW1000Class::crc16()
+    for b in data:
+        crc ^= b << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def registers(snapshot, include_volatile):
+    """Yields (name, value, length, fields) of every sub-register and
+    (name, value, 1, []) for bytes that are not part of a known sub-register."""
+    files = sorted(set(file for file, _ in snapshot.blocks))
+    for file in files:
+        name, volatile, subs = REGISTERS.get(file, ("0x%02X" % file, False, {}))
+        if volatile and not include_volatile:
+            continue
+        covered = set()
+        for offset in sorted(subs):
+            sub, length, sub_volatile, fields = subs[offset]
+            covered.update(range(offset, offset + length))
+            if sub_volatile and not include_volatile:
+                continue
+            value = snapshot.value(file, offset, length)
+            if value is not None:
+                label = sub if sub == name else "%s.%s" % (name, sub)
+                yield label, value, length, fields
+        for (f, offset), data in sorted(snapshot.blocks.items()):
+            if f != file:
+                continue
+            for address in range(offset, offset + len(data)):
+                if address not in covered:
+                    yield "%s+0x%02X" % (name, address), data[address - offset], 1, []
+
+
+def field(value, lsb, width):
+    return (value >> lsb) & ((1 << width) - 1)
+
+
+def print_snapshot(snapshot, include_volatile):
+    for label, value, length, fields in registers(snapshot, include_volatile):
+        text = "%-22s 0x%0*X" % (label, 2 * length, value)
+        if fields:
+            text += "  " + " ".join("%s=%d" % (f, field(value, lsb, width)) for f, lsb, width in fields)
+        print(text)
+
+
+def diff_snapshots(a, b, include_volatile):
+    other = dict((label, (value, length, fields)) for label, value, length, fields in
+                 registers(b, include_volatile))
+    differences = 0
+    for label, value, length, fields in registers(a, include_volatile):
+        if label not in other or other[label][0] == value:
+            continue
+        value_b = other[label][0]
+        differences += 1
+        print("%-22s 0x%0*X -> 0x%0*X" % (label, 2 * length, value, 2 * length, value_b))
+        for f, lsb, width in fields:
+            if field(value, lsb, width) != field(value_b, lsb, width):
+                print("    %-18s %d -> %d" % (f, field(value, lsb, width), field(value_b, lsb, width)))
+    return differences
+
+
+def read_port(port, baud):
+    import serial
+    data = bytearray()
+    with serial.Serial(port, baud, timeout=1) as line:
+        line.reset_input_buffer()
+        line.write(b"r")
+        while True:
+            chunk = line.read(4096)
+            data += chunk
+            snapshots, _ = decode(bytes(data))
+            if snapshots:
+                return bytes(data)
+            if not chunk:
+                sys.exit("no register snapshot received from %s" % port)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("captures", nargs="*", help="one capture file to decode, two to compare")
+    parser.add_argument("--port", help="read a snapshot live from this serial port instead")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--save", help="store the snapshot read from the port in this file")
+    parser.add_argument("--all", action="store_true", help="include volatile registers (time, status, ...)")
+    args = parser.parse_args()
+
+    snapshots = []
+    if args.port:
+        data = read_port(args.port, args.baud)
+        if args.save:
+            with open(args.save, "wb") as capture:
+                capture.write(data)
+        snapshots += decode(data)[0][:1]
+    for path in args.captures:
+        with open(path, "rb") as capture:
+            found, corrupted = decode(capture.read())
+        if not found:
+            sys.exit("no valid register snapshot in %s (%d corrupted)" % (path, corrupted))
+        snapshots.append(found[-1])
+    if len(snapshots) == 1:
+        print_snapshot(snapshots[0], args.all)
+    elif len(snapshots) == 2:
+        differences = diff_snapshots(snapshots[0], snapshots[1], args.all)
+        print("%d register(s) differ" % differences)
+        sys.exit(1 if differences else 0)
+    else:
+        parser.error("either one or two snapshots (captures and/or --port) are required")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,128 @@
+/*
+ * Decawave DW1000 library for arduino.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file tof_bench.cpp
+ * Host accuracy check and benchmark of the time of flight kernels (DW1000Tof).
+ *
+ * Simulates double-sided exchanges with random distances (0 to 300 m), reply
+ * times (100 us up to half the timer wrap, log-uniform) and clock offsets
+ * (+-40 ppm), and compares both kernels and the former plain 64 bit formula
+ * with the exact result (128 bit). Needs a compiler with __int128 (gcc, clang).
+ *
+ *   g++ -O2 -std=c++11 -I../../src tof_bench.cpp ../../src/DW1000Tof.cpp -o tof_bench
+ *   ./tof_bench [exchanges]
+ *
+ * Add -DDW1000TOF_NO_INT128 to check the portable 128 bit arithmetic used on MCUs.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <chrono>
+#include "DW1000Tof.h"
+
+static const double  TICKS_PER_METER = 1.0/0.004691763978616;
+static const int64_t DURATION_MAX    = 0xFFFFFFFFFFLL;
+
+struct Exchange {
+	int64_t round1, reply1, round2, reply2;
+	double  tof; // true time of flight [time units]
+};
+
+static uint64_t state = 0x9E3779B97F4A7C15ULL;
+
+static double random01() {
+	// xorshift64*
+	state ^= state >> 12;
+	state ^= state << 25;
+	state ^= state >> 27;
+	return ((state*0x2545F4914F6CDD1DULL) >> 11)*(1.0/9007199254740992.0);
+}
+
+static int64_t clip(double ticks) {
+	int64_t t = llround(ticks);
+	return t < 0 ? 0 : t > DURATION_MAX ? DURATION_MAX : t;
+}
+
+static Exchange randomExchange() {
+	// reply times in true time, log-uniform from 100 us to 2^39 time units
+	const double minReply = log(100e-6*63897.6e6), maxReply = log(549755813888.0);
+	Exchange e;
+	e.tof = random01()*300.0*TICKS_PER_METER;
+	double replyA = exp(minReply+random01()*(maxReply-minReply));
+	double replyB = exp(minReply+random01()*(maxReply-minReply));
+	double skew   = 1.0+(random01()*2.0-1.0)*40e-6; // clock of A relative to B
+	// B (initiator) measures round1 and reply2, A (responder) reply1 and round2
+	e.round1 = clip(2*e.tof+replyA);
+	e.reply1 = clip(replyA*skew);
+	e.round2 = clip((2*e.tof+replyB)*skew);
+	e.reply2 = clip(replyB);
+	return e;
+}
+
+static int64_t exact(const Exchange& e) {
+	__int128 numerator = (__int128)e.round1*e.round2-(__int128)e.reply1*e.reply2;
+	__int128 sum       = e.round1+e.round2+e.reply1+e.reply2;
+	__int128 magnitude = (numerator < 0 ? -numerator : numerator)+sum/2;
+	return (int64_t)(numerator < 0 ? -(magnitude/sum) : magnitude/sum);
+}
+
+// the formula as computed before: the int64 products overflow (undefined behaviour) for reply
+// times above about 45 ms, wrapping arithmetic is right only while the difference fits 63 bit
+static int64_t plain(const Exchange& e) {
+	return (e.round1*e.round2-e.reply1*e.reply2)/(e.round1+e.round2+e.reply1+e.reply2);
+}
+
+typedef int64_t (*Kernel)(int64_t, int64_t, int64_t, int64_t);
+
+static void check(const char* name, Kernel kernel, const Exchange* exchanges, int count) {
+	int64_t maxError   = 0;
+	double  trueError  = 0;
+	int     mismatches = 0;
+	for(int i = 0; i < count; i++) {
+		const Exchange& e = exchanges[i];
+		int64_t tof   = kernel(e.round1, e.reply1, e.round2, e.reply2);
+		int64_t error = llabs(tof-exact(e));
+		maxError  = error > maxError ? error : maxError;
+		trueError = fmax(trueError, fabs(tof-e.tof));
+		mismatches += error != 0;
+	}
+	volatile int64_t sink = 0;
+	auto start = std::chrono::steady_clock::now();
+	for(int i = 0; i < count; i++) {
+		const Exchange& e = exchanges[i];
+		sink += kernel(e.round1, e.reply1, e.round2, e.reply2);
+	}
+	double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now()-start).count()/count;
+	printf("%-6s  %10d  %14lld  %19.3f  %9.1f\n", name, mismatches, (long long)maxError, trueError/TICKS_PER_METER*1000, ns);
+}
+
+int main(int argc, char* argv[]) {
+	int count = argc > 1 ? atoi(argv[1]) : 1000000;
+	Exchange* exchanges = new Exchange[count];
+	for(int i = 0; i < count; i++) {
+		exchanges[i] = randomExchange();
+	}
+	printf("%d exchanges\n", count);
+	printf("kernel  mismatches  max error [tu]  max true error [mm]  [ns/call]\n");
+	check("exact", DW1000Tof::computeAsymmetricExact, exchanges, count);
+	check("float", DW1000Tof::computeAsymmetricFloat, exchanges, count);
+	check("plain", [](int64_t round1, int64_t reply1, int64_t round2, int64_t reply2) -> int64_t {
+		Exchange e = {round1, reply1, round2, reply2, 0};
+		return plain(e);
+	}, exchanges, count);
+	delete[] exchanges;
+	return 0;
+}
@@ -48,9 +48,28 @@ byte       DW1000Class::_sysmask[LEN_SYS_MASK];
 byte       DW1000Class::_chanctrl[LEN_CHAN_CTRL];
 byte       DW1000Class::_networkAndAddress[LEN_PANADR];
 
-// monitoring
-byte DW1000Class::_vmeas3v3 = 0;
-byte DW1000Class::_tmeas23C = 0;
+// calibration values from OTP
+DW1000Class::OtpCalibration DW1000Class::_otpCalibration;
+byte                        DW1000Class::_crystalTrim = 0x10;
+
+// temperature and voltage compensation
+boolean                              DW1000Class::_compensationEnabled  = false;
+boolean                              DW1000Class::_compensationDirty    = false;
+boolean                              DW1000Class::_sarConverting        = false;
+uint16_t                             DW1000Class::_compensationInterval = 1000;
+uint32_t                             DW1000Class::_compensationTime     = 0;
+uint32_t                             DW1000Class::_compensationSampleTime = 0;
+uint32_t                             DW1000Class::_sarStartTime         = 0;
+const DW1000Class::TempCompensation* DW1000Class::_tempCompensation     = nullptr;
+byte                                 DW1000Class::_tempCompensationRows = 0;
+const DW1000Class::VbatCompensation* DW1000Class::_vbatCompensation     = nullptr;
+byte                                 DW1000Class::_vbatCompensationRows = 0;
+byte                                 DW1000Class::_txPowerTuned[LEN_TX_POWER];
+byte                                 DW1000Class::_pgDelayTuned         = 0;
+DW1000Class::CompensationStatistics  DW1000Class::_compensationStatistics;
+
+// start up timing
+DW1000Class::BootProfile DW1000Class::_bootProfile;
 
 // driver internal state
 byte       DW1000Class::_extendedFrameLength = FRAME_LENGTH_NORMAL;
@@ -66,9 +85,13 @@ boolean    DW1000Class::_smartPower          = false;
 
 boolean    DW1000Class::_frameCheck          = true;
 boolean    DW1000Class::_permanentReceive    = false;
+byte       DW1000Class::_sniffOnTime         = 0;
+byte       DW1000Class::_sniffOffTime        = 0;
+boolean    DW1000Class::_sniffActive         = false;
 uint8_t    DW1000Class::_deviceMode          = IDLE_MODE; // TODO replace by enum
 
 boolean    DW1000Class::_debounceClockEnabled = false;
+uint32_t   DW1000Class::_wakeLatency          = 0;
 
 // modes of operation
 // TODO use enum external, not config array
@@ -79,6 +102,22 @@ constexpr byte DW1000Class::MODE_LONGDATA_FAST_LOWPOWER[];
 constexpr byte DW1000Class::MODE_SHORTDATA_FAST_ACCURACY[];
 constexpr byte DW1000Class::MODE_LONGDATA_FAST_ACCURACY[];
 constexpr byte DW1000Class::MODE_LONGDATA_RANGE_ACCURACY[];
+constexpr DW1000Profile DW1000Class::PROFILE_LONGDATA_RANGE_LOWPOWER;
+constexpr DW1000Profile DW1000Class::PROFILE_SHORTDATA_FAST_LOWPOWER;
+constexpr DW1000Profile DW1000Class::PROFILE_LONGDATA_FAST_LOWPOWER;
+constexpr DW1000Profile DW1000Class::PROFILE_SHORTDATA_FAST_ACCURACY;
+constexpr DW1000Profile DW1000Class::PROFILE_LONGDATA_FAST_ACCURACY;
+constexpr DW1000Profile DW1000Class::PROFILE_LONGDATA_RANGE_ACCURACY;
+constexpr uint16_t DW1000Class::CONFIG_SNAPSHOT_MAGIC;
+constexpr uint16_t DW1000Class::CONFIG_SNAPSHOT_VERSION;
+constexpr byte DW1000Profile::SFD_STANDARD;
+constexpr byte DW1000Profile::SFD_DECAWAVE;
+constexpr byte DW1000Profile::INVALID;
+
+// marks invalid settings of profiles that are built at run time (see DW1000Profile.h)
+byte DW1000Profile_illegal_combination_of_settings() {
+	return DW1000Profile::INVALID;
+}
 /*
 const byte DW1000Class::MODE_LONGDATA_RANGE_LOWPOWER[] = {TRX_RATE_110KBPS, TX_PULSE_FREQ_16MHZ, TX_PREAMBLE_LEN_2048};
 const byte DW1000Class::MODE_SHORTDATA_FAST_LOWPOWER[] = {TRX_RATE_6800KBPS, TX_PULSE_FREQ_16MHZ, TX_PREAMBLE_LEN_128};
@@ -117,17 +156,26 @@ void DW1000Class::end() {
 }
 
 void DW1000Class::select(uint8_t ss) {
+	uint32_t start = micros();
+	uint32_t since = start;
+	memset(&_bootProfile, 0, sizeof(BootProfile));
 	reselect(ss);
+	// wait for the chip to answer after power on (it still runs on the crystal clock)
+	_currentSPI = &_slowSPI;
+	if(!waitForBits(DEV_ID, NO_SUB, RIDTAG_MASK, RIDTAG_DECAWAVE, 5000)) {
+		_bootProfile.timeouts++;
+	}
+	_bootProfile.wakeup = bootPhase(since);
 	// try locking clock at PLL speed (should be done already,
 	// but just to be sure)
 	enableClock(AUTO_CLOCK);
-	delay(5);
 	// reset chip (either soft or hard)
 	if(_rst != 0xff) {
 		// dw1000 data sheet v2.08 §5.6.1 page 20, the RSTn pin should not be driven high but left floating.
 		pinMode(_rst, INPUT);
 	}
 	reset();
+	_bootProfile.reset = bootPhase(since);
 	// default network and node id
 	writeValueToBytes(_networkAndAddress, 0xFF, LEN_PANADR);
 	writeNetworkIdAndDeviceAddress();
@@ -139,21 +187,44 @@ void DW1000Class::select(uint8_t ss) {
 	// default interrupt mask, i.e. no interrupts
 	clearInterrupts();
 	writeSystemEventMaskRegister();
-	// load LDE micro-code
+	_bootProfile.setup = bootPhase(since);
+	// OTP is read on the crystal clock, as is the LDE micro-code loaded
 	enableClock(XTI_CLOCK);
-	delay(5);
+	loadOtpCalibration();
+	_bootProfile.otp = bootPhase(since);
 	manageLDE();
-	delay(5);
+	// the PLL kept running (and locked) while the system clock was forced to the crystal
 	enableClock(AUTO_CLOCK);
-	delay(5);
-	
-	// read the temp and vbat readings from OTP that were recorded during production test
-	// see 6.3.1 OTP memory map
-	byte buf_otp[4];
-	readBytesOTP(0x008, buf_otp); // the stored 3.3 V reading
-	_vmeas3v3 = buf_otp[0];
-	readBytesOTP(0x009, buf_otp); // the stored 23C reading
-	_tmeas23C = buf_otp[0];
+	_bootProfile.lde   = bootPhase(since);
+	_bootProfile.total = micros()-start;
+}
+
+void DW1000Class::loadOtpCalibration() {
+	// see 6.3.1 OTP memory map, LDO tune, part id, lot id and the voltage and temperature readings are consecutive
+	byte words[6*LEN_OTP_RDAT];
+	readBytesOTP(OTP_LDOTUNE_ADDR, words, 6);
+	memcpy(_otpCalibration.ldoTune, words, LEN_OTP_LDOTUNE);
+	_otpCalibration.partId   = bytesAsValue(words+(OTP_PARTID_ADDR-OTP_LDOTUNE_ADDR)*LEN_OTP_RDAT, LEN_OTP_RDAT);
+	_otpCalibration.lotId    = bytesAsValue(words+(OTP_LOTID_ADDR-OTP_LDOTUNE_ADDR)*LEN_OTP_RDAT, LEN_OTP_RDAT);
+	_otpCalibration.vmeas3v3 = words[(OTP_VBAT_ADDR-OTP_LDOTUNE_ADDR)*LEN_OTP_RDAT];
+	_otpCalibration.tmeas23C = words[(OTP_VTEMP_ADDR-OTP_LDOTUNE_ADDR)*LEN_OTP_RDAT];
+	readBytesOTP(OTP_ANTDELAY_ADDR, words, 1);
+	_otpCalibration.antennaDelay16 = bytesAsValue(words, 2);
+	_otpCalibration.antennaDelay64 = bytesAsValue(words+2, 2);
+	readBytesOTP(OTP_XTALT_ADDR, words, 1);
+	_otpCalibration.xtalTrim = words[0] & FS_XTALT_MAX;
+	_crystalTrim = (_otpCalibration.xtalTrim == 0 ? 0x10 : _otpCalibration.xtalTrim);
+	// have the chip load the LDO tune value if it has been calibrated
+	if(_otpCalibration.ldoTune[0] != 0) {
+		writeByte(OTP_IF, OTP_SF_SUB, 1 << LDO_KICK_BIT);
+	}
+}
+
+uint16_t DW1000Class::bootPhase(uint32_t& since) {
+	uint32_t now     = micros();
+	uint32_t elapsed = now-since;
+	since = now;
+	return (elapsed > 0xFFFF ? 0xFFFF : (uint16_t)elapsed);
 }
 
 void DW1000Class::reselect(uint8_t ss) {
@@ -163,8 +234,7 @@ void DW1000Class::reselect(uint8_t ss) {
 }
 
 void DW1000Class::begin(uint8_t irq, uint8_t rst) {
-	// generous initial init/wake-up-idle delay
-	delay(5);
+	// no initial wake-up delay, select() waits until the chip answers
 	// Configure the IRQ pin as INPUT. Required for correct interrupt setting for ESP8266
     	pinMode(irq, INPUT);
 	// start SPI
@@ -183,12 +253,6 @@ void DW1000Class::begin(uint8_t irq, uint8_t rst) {
 }
 
 void DW1000Class::manageLDE() {
-	// transfer any ldo tune values
-	byte ldoTune[LEN_OTP_RDAT];
-	readBytesOTP(0x04, ldoTune); // TODO #define
-	if(ldoTune[0] != 0) {
-		// TODO tuning available, copy over to RAM: use OTP_LDO bit
-	}
 	// tell the chip to load the LDE microcode
 	// TODO remove clock-related code (PMSC_CTRL) as handled separately
 	byte pmscctrl0[LEN_PMSC_CTRL0];
@@ -203,7 +267,10 @@ void DW1000Class::manageLDE() {
 	otpctrl[1]   = 0x80;
 	writeBytes(PMSC, PMSC_CTRL0_SUB, pmscctrl0, 2);
 	writeBytes(OTP_IF, OTP_CTRL_SUB, otpctrl, 2);
-	delay(5);
+	// loading takes about 150 us, LDELOAD clears when done
+	if(!waitForBits(OTP_IF, OTP_CTRL_SUB, (uint32_t)1 << LDELOAD_BIT, 0, 5000)) {
+		_bootProfile.timeouts++;
+	}
 	pmscctrl0[0] = 0x00;
 	pmscctrl0[1] &= 0x02;
 	writeBytes(PMSC, PMSC_CTRL0_SUB, pmscctrl0, 2);
@@ -231,6 +298,16 @@ void DW1000Class::enableClock(byte clock) {
 	writeBytes(PMSC, PMSC_CTRL0_SUB, pmscctrl0, 2);
 }
 
+boolean DW1000Class::waitForClockLock(uint16_t timeoutUs) {
+	// until locked, the chip runs on the crystal clock and needs slow SPI
+	const SPISettings* spi = _currentSPI;
+	_currentSPI = &_slowSPI;
+	boolean locked = waitForBits(DEV_ID, NO_SUB, RIDTAG_MASK, RIDTAG_DECAWAVE, timeoutUs) &&
+	                 waitForBits(SYS_STATUS, NO_SUB, (uint32_t)1 << CPLOCK_BIT, (uint32_t)1 << CPLOCK_BIT, timeoutUs);
+	_currentSPI = spi;
+	return locked;
+}
+
 void DW1000Class::enableDebounceClock() {
 	byte pmscctrl0[LEN_PMSC_CTRL0];
 	memset(pmscctrl0, 0, LEN_PMSC_CTRL0);
@@ -260,11 +337,17 @@ void DW1000Class::setGPIOMode(uint8_t msgp, uint8_t mode) {
 }
 
 void DW1000Class::deepSleep() {
+	// the transceiver has to be off before going to sleep
+	idle();
 	byte aon_wcfg[LEN_AON_WCFG];
 	memset(aon_wcfg, 0, LEN_AON_WCFG);
 	readBytes(AON, AON_WCFG_SUB, aon_wcfg, LEN_AON_WCFG);
+	// on wake-up restore the configuration, reload the LDE microcode and the LDO tune value
 	setBit(aon_wcfg, LEN_AON_WCFG, ONW_LDC_BIT, true);
+	setBit(aon_wcfg, LEN_AON_WCFG, ONW_LLDE_BIT, true);
 	setBit(aon_wcfg, LEN_AON_WCFG, ONW_LDD0_BIT, true);
+	// and the receiver parameter set for 64 symbols preambles if used
+	setBit(aon_wcfg, LEN_AON_WCFG, ONW_L64P_BIT, _preambleLength == TX_PREAMBLE_LEN_64);
 	writeBytes(AON, AON_WCFG_SUB, aon_wcfg, LEN_AON_WCFG);
 
 	byte pmsc_ctrl1[LEN_PMSC_CTRL1];
@@ -291,13 +374,45 @@ void DW1000Class::deepSleep() {
 	writeBytes(AON, AON_CTRL_SUB, aon_ctrl, LEN_AON_CTRL);
 }
 
-void DW1000Class::spiWakeup(){
+boolean DW1000Class::spiWakeup(){
+        uint32_t start = micros();
+        // user manual 2.4.2: chip select has to be held low for at least 500 us
         digitalWrite(_ss, LOW);
-        delay(2);
+        delayMicroseconds(600);
         digitalWrite(_ss, HIGH);
+        // crystal start up and PLL lock, meanwhile AON restores the configuration and LDE microcode
+        boolean ready = waitForClockLock(5000);
+        _deviceMode  = IDLE_MODE;
+        _sniffActive = false;
+        if (ready){
+                restoreConfiguration();
+        }
         if (_debounceClockEnabled){
                 DW1000Class::enableDebounceClock();
         }
+        _wakeLatency = micros()-start;
+        return ready;
+}
+
+void DW1000Class::restoreConfiguration() {
+	// the receiver antenna delay is not kept in AON (with the compensation, as the transmitter one)
+	writeAntennaDelay();
+	// the rest should be back, check the registers that carry most of the configuration
+	byte syscfg[LEN_SYS_CFG];
+	byte chanctrl[LEN_CHAN_CTRL];
+	readBytes(SYS_CFG, NO_SUB, syscfg, LEN_SYS_CFG);
+	readBytes(CHAN_CTRL, NO_SUB, chanctrl, LEN_CHAN_CTRL);
+	if(memcmp(syscfg, _syscfg, LEN_SYS_CFG) == 0 && memcmp(chanctrl, _chanctrl, LEN_CHAN_CTRL) == 0) {
+		return;
+	}
+	// retention failed, write everything again (same as commitConfiguration())
+	writeNetworkIdAndDeviceAddress();
+	writeSystemConfigurationRegister();
+	writeChannelControlRegister();
+	writeTransmitFrameControlRegister();
+	writeSystemEventMaskRegister();
+	tune();
+	writeAntennaDelay();
 }
 
 
@@ -310,7 +425,11 @@ void DW1000Class::reset() {
 		digitalWrite(_rst, LOW);
 		delay(2);  // dw1000 data sheet v2.08 §5.6.1 page 20: nominal 50ns, to be safe take more time
 		pinMode(_rst, INPUT);
-		delay(10); // dwm1000 data sheet v1.2 page 5: nominal 3 ms, to be safe take more time
+		// dwm1000 data sheet v1.2 page 5: nominal 3 ms, wait for the clock PLL lock (at most 10 ms)
+		if(!waitForClockLock(10000)) {
+			_bootProfile.timeouts++;
+		}
+		_sniffActive = false;
 		// force into idle mode (although it should be already after reset)
 		idle();
 	}
@@ -327,6 +446,7 @@ void DW1000Class::softReset() {
 	pmscctrl0[0] = 0x00;
 	pmscctrl0[3] = 0xF0;
 	writeBytes(PMSC, PMSC_CTRL0_SUB, pmscctrl0, LEN_PMSC_CTRL0);
+	_sniffActive = false;
 	// force into idle mode
 	idle();
 }
@@ -337,371 +457,346 @@ void DW1000Class::enableMode(const byte mode[]) {
 	setPreambleLength(mode[2]);
 }
 
-void DW1000Class::tune() {
-	// these registers are going to be tuned/configured
-	byte agctune1[LEN_AGC_TUNE1];
-	byte agctune2[LEN_AGC_TUNE2];
-	byte agctune3[LEN_AGC_TUNE3];
-	byte drxtune0b[LEN_DRX_TUNE0b];
-	byte drxtune1a[LEN_DRX_TUNE1a];
-	byte drxtune1b[LEN_DRX_TUNE1b];
-	byte drxtune2[LEN_DRX_TUNE2];
-	byte drxtune4H[LEN_DRX_TUNE4H];
-	byte ldecfg1[LEN_LDE_CFG1];
-	byte ldecfg2[LEN_LDE_CFG2];
-	byte lderepc[LEN_LDE_REPC];
-	byte txpower[LEN_TX_POWER];
-	byte rfrxctrlh[LEN_RF_RXCTRLH];
-	byte rftxctrl[LEN_RF_TXCTRL];
-	byte tcpgdelay[LEN_TC_PGDELAY];
-	byte fspllcfg[LEN_FS_PLLCFG];
-	byte fsplltune[LEN_FS_PLLTUNE];
-	byte fsxtalt[LEN_FS_XTALT];
-	// AGC_TUNE1
-	if(_pulseFrequency == TX_PULSE_FREQ_16MHZ) {
-		writeValueToBytes(agctune1, 0x8870, LEN_AGC_TUNE1);
-	} else if(_pulseFrequency == TX_PULSE_FREQ_64MHZ) {
-		writeValueToBytes(agctune1, 0x889B, LEN_AGC_TUNE1);
-	} else {
-		// TODO proper error/warning handling
-	}
-	// AGC_TUNE2
-	writeValueToBytes(agctune2, 0x2502A907L, LEN_AGC_TUNE2);
-	// AGC_TUNE3
-	writeValueToBytes(agctune3, 0x0035, LEN_AGC_TUNE3);
-	// DRX_TUNE0b (already optimized according to Table 20 of user manual)
-	if(_dataRate == TRX_RATE_110KBPS) {
-		writeValueToBytes(drxtune0b, 0x0016, LEN_DRX_TUNE0b);
-	} else if(_dataRate == TRX_RATE_850KBPS) {
-		writeValueToBytes(drxtune0b, 0x0006, LEN_DRX_TUNE0b);
-	} else if(_dataRate == TRX_RATE_6800KBPS) {
-		writeValueToBytes(drxtune0b, 0x0001, LEN_DRX_TUNE0b);
-	} else {
-		// TODO proper error/warning handling
-	}
-	// DRX_TUNE1a
-	if(_pulseFrequency == TX_PULSE_FREQ_16MHZ) {
-		writeValueToBytes(drxtune1a, 0x0087, LEN_DRX_TUNE1a);
-	} else if(_pulseFrequency == TX_PULSE_FREQ_64MHZ) {
-		writeValueToBytes(drxtune1a, 0x008D, LEN_DRX_TUNE1a);
-	} else {
-		// TODO proper error/warning handling
-	}
-	// DRX_TUNE1b
-	if(_preambleLength == TX_PREAMBLE_LEN_1536 || _preambleLength == TX_PREAMBLE_LEN_2048 ||
-		 _preambleLength == TX_PREAMBLE_LEN_4096) {
-		if(_dataRate == TRX_RATE_110KBPS) {
-			writeValueToBytes(drxtune1b, 0x0064, LEN_DRX_TUNE1b);
-		} else {
-			// TODO proper error/warning handling
-		}
-	} else if(_preambleLength != TX_PREAMBLE_LEN_64) {
-		if(_dataRate == TRX_RATE_850KBPS || _dataRate == TRX_RATE_6800KBPS) {
-			writeValueToBytes(drxtune1b, 0x0020, LEN_DRX_TUNE1b);
-		} else {
-			// TODO proper error/warning handling
-		}
-	} else {
-		if(_dataRate == TRX_RATE_6800KBPS) {
-			writeValueToBytes(drxtune1b, 0x0010, LEN_DRX_TUNE1b);
-		} else {
-			// TODO proper error/warning handling
-		}
+boolean DW1000Class::enableMode(const DW1000Profile& profile) {
+	if(!profile.isValid()) {
+		return false;
 	}
-	// DRX_TUNE2
+	// also selects the SFD, which goes with the data rate (see DW1000Profile::isValidSfd())
+	setDataRate(profile.dataRate);
+	setPulseFrequency(profile.pulseFrequency);
+	setPreambleLength(profile.preambleLength);
+	// channel selection picks a default preamble code, so code goes after channel
+	setChannel(profile.channel);
+	setPreambleCode(profile.preambleCode);
+	_pacSize = profile.pacSize;
+	return true;
+}
+
+void DW1000Class::tune() {
+	TuneImage image;
+	buildTuneImage(image);
+	applyTuneImage(image);
+}
+
+/* Tuning tables, indexed by PRF (16, 64 MHz), data rate, PAC size, channel (1, 2, 3, 4, 5, 7) and preamble
+ * code. Multi-byte values are copied as they are, AVR and ARM are little endian like the DW1000. */
+static const uint16_t AGC_TUNE1_VALUES[] PROGMEM  = {0x8870, 0x889B};
+static const uint32_t AGC_TUNE2_VALUE PROGMEM     = 0x2502A907L;
+static const uint16_t AGC_TUNE3_VALUE PROGMEM     = 0x0035;
+// DRX_TUNE0b already optimized according to Table 20 of user manual
+static const uint16_t DRX_TUNE0b_VALUES[] PROGMEM = {0x0016, 0x0006, 0x0001};
+static const uint16_t DRX_TUNE1a_VALUES[] PROGMEM = {0x0087, 0x008D};
+static const uint32_t DRX_TUNE2_VALUES[][2] PROGMEM = {
+	{0x311A002DL, 0x313B006BL}, // PAC 8
+	{0x331A0052L, 0x333B00BEL}, // PAC 16
+	{0x351A009AL, 0x353B015EL}, // PAC 32
+	{0x371A011DL, 0x373B0296L}  // PAC 64
+};
+static const byte     LDE_CFG1_VALUE PROGMEM      = 0xD;
+static const uint16_t LDE_CFG2_VALUES[] PROGMEM   = {0x1607, 0x0607};
+// 0 for preamble codes that are not in use
+static const uint16_t LDE_REPC_VALUES[] PROGMEM   = {
+	0x0000, 0x5998, 0x5998, 0x51EA, 0x428E, 0x451E, 0x2E14, 0x8000, 0x51EA, 0x28F4, 0x3332,
+	0x3AE0, 0x3D70, 0x0000, 0x0000, 0x0000, 0x0000, 0x3332, 0x35C2, 0x35C2, 0x47AE
+};
+static const byte     RF_RXCTRLH_VALUES[] PROGMEM = {0xD8, 0xD8, 0xD8, 0xBC, 0xD8, 0xBC};
+static const uint32_t RF_TXCTRL_VALUES[] PROGMEM  = {
+	0x00005C40L, 0x00045CA0L, 0x00086CC0L, 0x00045C80L, 0x001E3FE0L, 0x001E7DE0L
+};
+static const byte     TC_PGDELAY_VALUES[] PROGMEM = {0xC9, 0xC2, 0xC5, 0x95, 0xC0, 0x93};
+static const uint32_t FS_PLLCFG_VALUES[] PROGMEM  = {
+	0x09000407L, 0x08400508L, 0x08401009L, 0x08400508L, 0x0800041DL, 0x0800041DL
+};
+static const byte     FS_PLLTUNE_VALUES[] PROGMEM = {0x1E, 0x26, 0x56, 0x26, 0xBE, 0xBE};
+// TX_POWER per channel and PRF, with smart transmit power control enabled and disabled
+static const uint32_t TX_POWER_VALUES[][2][2] PROGMEM = {
+	{{0x15355575L, 0x75757575L}, {0x07274767L, 0x67676767L}}, // channel 1
+	{{0x15355575L, 0x75757575L}, {0x07274767L, 0x67676767L}}, // channel 2
+	{{0x0F2F4F6FL, 0x6F6F6F6FL}, {0x2B4B6B8BL, 0x8B8B8B8BL}}, // channel 3
+	{{0x1F1F3F5FL, 0x5F5F5F5FL}, {0x3A5A7A9AL, 0x9A9A9A9AL}}, // channel 4
+	{{0x0E082848L, 0x48484848L}, {0x25456585L, 0x85858585L}}, // channel 5
+	{{0x32527292L, 0x92929292L}, {0x5171B1D1L, 0xD1D1D1D1L}}  // channel 7
+};
+
+void DW1000Class::buildTuneImage(TuneImage& image) {
+	byte prf     = (_pulseFrequency == TX_PULSE_FREQ_64MHZ ? 1 : 0);
+	byte rate    = (_dataRate <= TRX_RATE_6800KBPS ? _dataRate : TRX_RATE_6800KBPS);
+	byte channel = (_channel == CHANNEL_7 ? 5 : (_channel >= CHANNEL_1 && _channel <= CHANNEL_5 ? _channel-1 : 4));
+	byte pac;
 	if(_pacSize == PAC_SIZE_8) {
-		if(_pulseFrequency == TX_PULSE_FREQ_16MHZ) {
-			writeValueToBytes(drxtune2, 0x311A002DL, LEN_DRX_TUNE2);
-		} else if(_pulseFrequency == TX_PULSE_FREQ_64MHZ) {
-			writeValueToBytes(drxtune2, 0x313B006BL, LEN_DRX_TUNE2);
-		} else {
-			// TODO proper error/warning handling
-		}
+		pac = 0;
 	} else if(_pacSize == PAC_SIZE_16) {
-		if(_pulseFrequency == TX_PULSE_FREQ_16MHZ) {
-			writeValueToBytes(drxtune2, 0x331A0052L, LEN_DRX_TUNE2);
-		} else if(_pulseFrequency == TX_PULSE_FREQ_64MHZ) {
-			writeValueToBytes(drxtune2, 0x333B00BEL, LEN_DRX_TUNE2);
-		} else {
-			// TODO proper error/warning handling
-		}
+		pac = 1;
 	} else if(_pacSize == PAC_SIZE_32) {
-		if(_pulseFrequency == TX_PULSE_FREQ_16MHZ) {
-			writeValueToBytes(drxtune2, 0x351A009AL, LEN_DRX_TUNE2);
-		} else if(_pulseFrequency == TX_PULSE_FREQ_64MHZ) {
-			writeValueToBytes(drxtune2, 0x353B015EL, LEN_DRX_TUNE2);
-		} else {
-			// TODO proper error/warning handling
-		}
-	} else if(_pacSize == PAC_SIZE_64) {
-		if(_pulseFrequency == TX_PULSE_FREQ_16MHZ) {
-			writeValueToBytes(drxtune2, 0x371A011DL, LEN_DRX_TUNE2);
-		} else if(_pulseFrequency == TX_PULSE_FREQ_64MHZ) {
-			writeValueToBytes(drxtune2, 0x373B0296L, LEN_DRX_TUNE2);
-		} else {
-			// TODO proper error/warning handling
-		}
+		pac = 2;
+	} else {
+		pac = 3;
+	}
+	// mode registers and driver state
+	memcpy(image.syscfg, _syscfg, LEN_SYS_CFG);
+	memcpy(image.chanctrl, _chanctrl, LEN_CHAN_CTRL);
+	memcpy(image.txfctrl, _txfctrl, LEN_TX_FCTRL);
+	// SFD length as set by setDataRate()
+	image.sfdLength      = (_dataRate == TRX_RATE_6800KBPS ? 0x08 : (_dataRate == TRX_RATE_850KBPS ? 0x10 : 0x40));
+	image.channel        = _channel;
+	image.dataRate       = _dataRate;
+	image.pulseFrequency = _pulseFrequency;
+	image.preambleLength = _preambleLength;
+	image.preambleCode   = _preambleCode;
+	image.pacSize        = _pacSize;
+	// AGC_TUNE1
+	memcpy_P(image.agctune1, &AGC_TUNE1_VALUES[prf], LEN_AGC_TUNE1);
+	// DRX_TUNE0b, DRX_TUNE1a, DRX_TUNE1b and DRX_TUNE2 (consecutive registers)
+	memcpy_P(image.drxtune+DRX_TUNE0b_SUB-DRX_TUNE0b_SUB, &DRX_TUNE0b_VALUES[rate], LEN_DRX_TUNE0b);
+	memcpy_P(image.drxtune+DRX_TUNE1a_SUB-DRX_TUNE0b_SUB, &DRX_TUNE1a_VALUES[prf], LEN_DRX_TUNE1a);
+	if(_dataRate == TRX_RATE_110KBPS) {
+		writeValueToBytes(image.drxtune+DRX_TUNE1b_SUB-DRX_TUNE0b_SUB, 0x0064, LEN_DRX_TUNE1b);
+	} else if(_preambleLength == TX_PREAMBLE_LEN_64) {
+		writeValueToBytes(image.drxtune+DRX_TUNE1b_SUB-DRX_TUNE0b_SUB, 0x0010, LEN_DRX_TUNE1b);
 	} else {
-		// TODO proper error/warning handling
+		writeValueToBytes(image.drxtune+DRX_TUNE1b_SUB-DRX_TUNE0b_SUB, 0x0020, LEN_DRX_TUNE1b);
 	}
+	memcpy_P(image.drxtune+DRX_TUNE2_SUB-DRX_TUNE0b_SUB, &DRX_TUNE2_VALUES[pac][prf], LEN_DRX_TUNE2);
 	// DRX_TUNE4H
 	if(_preambleLength == TX_PREAMBLE_LEN_64) {
-		writeValueToBytes(drxtune4H, 0x0010, LEN_DRX_TUNE4H);
-	} else {
-		writeValueToBytes(drxtune4H, 0x0028, LEN_DRX_TUNE4H);
-	}
-	// RF_RXCTRLH
-	if(_channel != CHANNEL_4 && _channel != CHANNEL_7) {
-		writeValueToBytes(rfrxctrlh, 0xD8, LEN_RF_RXCTRLH);
+		writeValueToBytes(image.drxtune4H, 0x0010, LEN_DRX_TUNE4H);
 	} else {
-		writeValueToBytes(rfrxctrlh, 0xBC, LEN_RF_RXCTRLH);
+		writeValueToBytes(image.drxtune4H, 0x0028, LEN_DRX_TUNE4H);
 	}
-	// RX_TXCTRL
-	if(_channel == CHANNEL_1) {
-		writeValueToBytes(rftxctrl, 0x00005C40L, LEN_RF_TXCTRL);
-	} else if(_channel == CHANNEL_2) {
-		writeValueToBytes(rftxctrl, 0x00045CA0L, LEN_RF_TXCTRL);
-	} else if(_channel == CHANNEL_3) {
-		writeValueToBytes(rftxctrl, 0x00086CC0L, LEN_RF_TXCTRL);
-	} else if(_channel == CHANNEL_4) {
-		writeValueToBytes(rftxctrl, 0x00045C80L, LEN_RF_TXCTRL);
-	} else if(_channel == CHANNEL_5) {
-		writeValueToBytes(rftxctrl, 0x001E3FE0L, LEN_RF_TXCTRL);
-	} else if(_channel == CHANNEL_7) {
-		writeValueToBytes(rftxctrl, 0x001E7DE0L, LEN_RF_TXCTRL);
-	} else {
-		// TODO proper error/warning handling
-	}
-	// TC_PGDELAY
-	if(_channel == CHANNEL_1) {
-		writeValueToBytes(tcpgdelay, 0xC9, LEN_TC_PGDELAY);
-	} else if(_channel == CHANNEL_2) {
-		writeValueToBytes(tcpgdelay, 0xC2, LEN_TC_PGDELAY);
-	} else if(_channel == CHANNEL_3) {
-		writeValueToBytes(tcpgdelay, 0xC5, LEN_TC_PGDELAY);
-	} else if(_channel == CHANNEL_4) {
-		writeValueToBytes(tcpgdelay, 0x95, LEN_TC_PGDELAY);
-	} else if(_channel == CHANNEL_5) {
-		writeValueToBytes(tcpgdelay, 0xC0, LEN_TC_PGDELAY);
-	} else if(_channel == CHANNEL_7) {
-		writeValueToBytes(tcpgdelay, 0x93, LEN_TC_PGDELAY);
-	} else {
-		// TODO proper error/warning handling
-	}
-	// FS_PLLCFG and FS_PLLTUNE
-	if(_channel == CHANNEL_1) {
-		writeValueToBytes(fspllcfg, 0x09000407L, LEN_FS_PLLCFG);
-		writeValueToBytes(fsplltune, 0x1E, LEN_FS_PLLTUNE);
-	} else if(_channel == CHANNEL_2 || _channel == CHANNEL_4) {
-		writeValueToBytes(fspllcfg, 0x08400508L, LEN_FS_PLLCFG);
-		writeValueToBytes(fsplltune, 0x26, LEN_FS_PLLTUNE);
-	} else if(_channel == CHANNEL_3) {
-		writeValueToBytes(fspllcfg, 0x08401009L, LEN_FS_PLLCFG);
-		writeValueToBytes(fsplltune, 0x56, LEN_FS_PLLTUNE);
-	} else if(_channel == CHANNEL_5 || _channel == CHANNEL_7) {
-		writeValueToBytes(fspllcfg, 0x0800041DL, LEN_FS_PLLCFG);
-		writeValueToBytes(fsplltune, 0xBE, LEN_FS_PLLTUNE);
-	} else {
-		// TODO proper error/warning handling
-	}
-	// LDE_CFG1
-	writeValueToBytes(ldecfg1, 0xD, LEN_LDE_CFG1);
 	// LDE_CFG2
-	if(_pulseFrequency == TX_PULSE_FREQ_16MHZ) {
-		writeValueToBytes(ldecfg2, 0x1607, LEN_LDE_CFG2);
-	} else if(_pulseFrequency == TX_PULSE_FREQ_64MHZ) {
-		writeValueToBytes(ldecfg2, 0x0607, LEN_LDE_CFG2);
-	} else {
-		// TODO proper error/warning handling
-	}
+	memcpy_P(image.ldecfg2, &LDE_CFG2_VALUES[prf], LEN_LDE_CFG2);
 	// LDE_REPC
-	if(_preambleCode == PREAMBLE_CODE_16MHZ_1 || _preambleCode == PREAMBLE_CODE_16MHZ_2) {
-		if(_dataRate == TRX_RATE_110KBPS) {
-			writeValueToBytes(lderepc, ((0x5998 >> 3) & 0xFFFF), LEN_LDE_REPC);
-		} else {
-			writeValueToBytes(lderepc, 0x5998, LEN_LDE_REPC);
-		}
-	} else if(_preambleCode == PREAMBLE_CODE_16MHZ_3 || _preambleCode == PREAMBLE_CODE_16MHZ_8) {
-		if(_dataRate == TRX_RATE_110KBPS) {
-			writeValueToBytes(lderepc, ((0x51EA >> 3) & 0xFFFF), LEN_LDE_REPC);
-		} else {
-			writeValueToBytes(lderepc, 0x51EA, LEN_LDE_REPC);
-		}
-	} else if(_preambleCode == PREAMBLE_CODE_16MHZ_4) {
-		if(_dataRate == TRX_RATE_110KBPS) {
-			writeValueToBytes(lderepc, ((0x428E >> 3) & 0xFFFF), LEN_LDE_REPC);
-		} else {
-			writeValueToBytes(lderepc, 0x428E, LEN_LDE_REPC);
-		}
-	} else if(_preambleCode == PREAMBLE_CODE_16MHZ_5) {
-		if(_dataRate == TRX_RATE_110KBPS) {
-			writeValueToBytes(lderepc, ((0x451E >> 3) & 0xFFFF), LEN_LDE_REPC);
-		} else {
-			writeValueToBytes(lderepc, 0x451E, LEN_LDE_REPC);
-		}
-	} else if(_preambleCode == PREAMBLE_CODE_16MHZ_6) {
-		if(_dataRate == TRX_RATE_110KBPS) {
-			writeValueToBytes(lderepc, ((0x2E14 >> 3) & 0xFFFF), LEN_LDE_REPC);
-		} else {
-			writeValueToBytes(lderepc, 0x2E14, LEN_LDE_REPC);
-		}
-	} else if(_preambleCode == PREAMBLE_CODE_16MHZ_7) {
-		if(_dataRate == TRX_RATE_110KBPS) {
-			writeValueToBytes(lderepc, ((0x8000 >> 3) & 0xFFFF), LEN_LDE_REPC);
-		} else {
-			writeValueToBytes(lderepc, 0x8000, LEN_LDE_REPC);
-		}
-	} else if(_preambleCode == PREAMBLE_CODE_64MHZ_9) {
-		if(_dataRate == TRX_RATE_110KBPS) {
-			writeValueToBytes(lderepc, ((0x28F4 >> 3) & 0xFFFF), LEN_LDE_REPC);
-		} else {
-			writeValueToBytes(lderepc, 0x28F4, LEN_LDE_REPC);
-		}
-	} else if(_preambleCode == PREAMBLE_CODE_64MHZ_10 || _preambleCode == PREAMBLE_CODE_64MHZ_17) {
-		if(_dataRate == TRX_RATE_110KBPS) {
-			writeValueToBytes(lderepc, ((0x3332 >> 3) & 0xFFFF), LEN_LDE_REPC);
-		} else {
-			writeValueToBytes(lderepc, 0x3332, LEN_LDE_REPC);
-		}
-	} else if(_preambleCode == PREAMBLE_CODE_64MHZ_11) {
-		if(_dataRate == TRX_RATE_110KBPS) {
-			writeValueToBytes(lderepc, ((0x3AE0 >> 3) & 0xFFFF), LEN_LDE_REPC);
-		} else {
-			writeValueToBytes(lderepc, 0x3AE0, LEN_LDE_REPC);
-		}
-	} else if(_preambleCode == PREAMBLE_CODE_64MHZ_12) {
-		if(_dataRate == TRX_RATE_110KBPS) {
-			writeValueToBytes(lderepc, ((0x3D70 >> 3) & 0xFFFF), LEN_LDE_REPC);
-		} else {
-			writeValueToBytes(lderepc, 0x3D70, LEN_LDE_REPC);
-		}
-	} else if(_preambleCode == PREAMBLE_CODE_64MHZ_18 || _preambleCode == PREAMBLE_CODE_64MHZ_19) {
-		if(_dataRate == TRX_RATE_110KBPS) {
-			writeValueToBytes(lderepc, ((0x35C2 >> 3) & 0xFFFF), LEN_LDE_REPC);
-		} else {
-			writeValueToBytes(lderepc, 0x35C2, LEN_LDE_REPC);
-		}
-	} else if(_preambleCode == PREAMBLE_CODE_64MHZ_20) {
-		if(_dataRate == TRX_RATE_110KBPS) {
-			writeValueToBytes(lderepc, ((0x47AE >> 3) & 0xFFFF), LEN_LDE_REPC);
-		} else {
-			writeValueToBytes(lderepc, 0x47AE, LEN_LDE_REPC);
-		}
-	} else {
-		// TODO proper error/warning handling
-	}
-	// TX_POWER (enabled smart transmit power control)
-	if(_channel == CHANNEL_1 || _channel == CHANNEL_2) {
-		if(_pulseFrequency == TX_PULSE_FREQ_16MHZ) {
-			if(_smartPower) {
-				writeValueToBytes(txpower, 0x15355575L, LEN_TX_POWER);
-			} else {
-				writeValueToBytes(txpower, 0x75757575L, LEN_TX_POWER);
-			}
-		} else if(_pulseFrequency == TX_PULSE_FREQ_64MHZ) {
-			if(_smartPower) {
-				writeValueToBytes(txpower, 0x07274767L, LEN_TX_POWER);
-			} else {
-				writeValueToBytes(txpower, 0x67676767L, LEN_TX_POWER);
-			}
-		} else {
-			// TODO proper error/warning handling
-		}
-	} else if(_channel == CHANNEL_3) {
-		if(_pulseFrequency == TX_PULSE_FREQ_16MHZ) {
-			if(_smartPower) {
-				writeValueToBytes(txpower, 0x0F2F4F6FL, LEN_TX_POWER);
-			} else {
-				writeValueToBytes(txpower, 0x6F6F6F6FL, LEN_TX_POWER);
-			}
-		} else if(_pulseFrequency == TX_PULSE_FREQ_64MHZ) {
-			if(_smartPower) {
-				writeValueToBytes(txpower, 0x2B4B6B8BL, LEN_TX_POWER);
-			} else {
-				writeValueToBytes(txpower, 0x8B8B8B8BL, LEN_TX_POWER);
-			}
-		} else {
-			// TODO proper error/warning handling
-		}
-	} else if(_channel == CHANNEL_4) {
-		if(_pulseFrequency == TX_PULSE_FREQ_16MHZ) {
-			if(_smartPower) {
-				writeValueToBytes(txpower, 0x1F1F3F5FL, LEN_TX_POWER);
-			} else {
-				writeValueToBytes(txpower, 0x5F5F5F5FL, LEN_TX_POWER);
-			}
-		} else if(_pulseFrequency == TX_PULSE_FREQ_64MHZ) {
-			if(_smartPower) {
-				writeValueToBytes(txpower, 0x3A5A7A9AL, LEN_TX_POWER);
-			} else {
-				writeValueToBytes(txpower, 0x9A9A9A9AL, LEN_TX_POWER);
-			}
-		} else {
-			// TODO proper error/warning handling
-		}
-	} else if(_channel == CHANNEL_5) {
-		if(_pulseFrequency == TX_PULSE_FREQ_16MHZ) {
-			if(_smartPower) {
-				writeValueToBytes(txpower, 0x0E082848L, LEN_TX_POWER);
-			} else {
-				writeValueToBytes(txpower, 0x48484848L, LEN_TX_POWER);
-			}
-		} else if(_pulseFrequency == TX_PULSE_FREQ_64MHZ) {
-			if(_smartPower) {
-				writeValueToBytes(txpower, 0x25456585L, LEN_TX_POWER);
-			} else {
-				writeValueToBytes(txpower, 0x85858585L, LEN_TX_POWER);
-			}
-		} else {
-			// TODO proper error/warning handling
-		}
-	} else if(_channel == CHANNEL_7) {
-		if(_pulseFrequency == TX_PULSE_FREQ_16MHZ) {
-			if(_smartPower) {
-				writeValueToBytes(txpower, 0x32527292L, LEN_TX_POWER);
-			} else {
-				writeValueToBytes(txpower, 0x92929292L, LEN_TX_POWER);
-			}
-		} else if(_pulseFrequency == TX_PULSE_FREQ_64MHZ) {
-			if(_smartPower) {
-				writeValueToBytes(txpower, 0x5171B1D1L, LEN_TX_POWER);
-			} else {
-				writeValueToBytes(txpower, 0xD1D1D1D1L, LEN_TX_POWER);
-			}
-		} else {
-			// TODO proper error/warning handling
-		}
-	} else {
-		// TODO proper error/warning handling
-	}
-	// Crystal calibration from OTP (if available)
-	byte buf_otp[4];
-	readBytesOTP(0x01E, buf_otp);
-	if (buf_otp[0] == 0) {
-		// No trim value available from OTP, use midrange value of 0x10
-		writeValueToBytes(fsxtalt, ((0x10 & 0x1F) | 0x60), LEN_FS_XTALT);
-	} else {
-		writeValueToBytes(fsxtalt, ((buf_otp[0] & 0x1F) | 0x60), LEN_FS_XTALT);
+	uint16_t repc = 0;
+	if(_preambleCode < sizeof(LDE_REPC_VALUES)/sizeof(LDE_REPC_VALUES[0])) {
+		repc = pgm_read_word(&LDE_REPC_VALUES[_preambleCode]);
 	}
-	// write configuration back to chip
-	writeBytes(AGC_TUNE, AGC_TUNE1_SUB, agctune1, LEN_AGC_TUNE1);
+	if(_dataRate == TRX_RATE_110KBPS) {
+		repc >>= 3;
+	}
+	writeValueToBytes(image.lderepc, repc, LEN_LDE_REPC);
+	// TX_POWER
+	memcpy_P(image.txpower, &TX_POWER_VALUES[channel][prf][_smartPower ? 0 : 1], LEN_TX_POWER);
+	// RF_RXCTRLH and RF_TXCTRL (consecutive registers)
+	image.rfconf[0] = pgm_read_byte(&RF_RXCTRLH_VALUES[channel]);
+	memcpy_P(image.rfconf+RF_TXCTRL_SUB-RF_RXCTRLH_SUB, &RF_TXCTRL_VALUES[channel], LEN_RF_TXCTRL);
+	// TC_PGDELAY
+	image.tcpgdelay[0] = pgm_read_byte(&TC_PGDELAY_VALUES[channel]);
+	// FS_PLLCFG and FS_PLLTUNE (consecutive registers)
+	memcpy_P(image.fspll, &FS_PLLCFG_VALUES[channel], LEN_FS_PLLCFG);
+	image.fspll[FS_PLLTUNE_SUB-FS_PLLCFG_SUB] = pgm_read_byte(&FS_PLLTUNE_VALUES[channel]);
+	// FS_XTALT, crystal calibration from OTP (if available, read once in select())
+	image.fsxtalt[0] = (_crystalTrim & FS_XTALT_MAX) | 0x60;
+}
+
+void DW1000Class::applyTuneImage(const TuneImage& image) {
+	// constant values, still needed after each reset
+	byte agctune2[LEN_AGC_TUNE2];
+	byte agctune3[LEN_AGC_TUNE3];
+	byte ldecfg1[LEN_LDE_CFG1];
+	memcpy_P(agctune2, &AGC_TUNE2_VALUE, LEN_AGC_TUNE2);
+	memcpy_P(agctune3, &AGC_TUNE3_VALUE, LEN_AGC_TUNE3);
+	memcpy_P(ldecfg1, &LDE_CFG1_VALUE, LEN_LDE_CFG1);
+	// write configuration back to chip, one burst per block of consecutive registers
+	writeBytes(AGC_TUNE, AGC_TUNE1_SUB, (byte*)image.agctune1, LEN_AGC_TUNE1);
 	writeBytes(AGC_TUNE, AGC_TUNE2_SUB, agctune2, LEN_AGC_TUNE2);
 	writeBytes(AGC_TUNE, AGC_TUNE3_SUB, agctune3, LEN_AGC_TUNE3);
-	writeBytes(DRX_TUNE, DRX_TUNE0b_SUB, drxtune0b, LEN_DRX_TUNE0b);
-	writeBytes(DRX_TUNE, DRX_TUNE1a_SUB, drxtune1a, LEN_DRX_TUNE1a);
-	writeBytes(DRX_TUNE, DRX_TUNE1b_SUB, drxtune1b, LEN_DRX_TUNE1b);
-	writeBytes(DRX_TUNE, DRX_TUNE2_SUB, drxtune2, LEN_DRX_TUNE2);
-	writeBytes(DRX_TUNE, DRX_TUNE4H_SUB, drxtune4H, LEN_DRX_TUNE4H);
+	writeBytes(DRX_TUNE, DRX_TUNE0b_SUB, (byte*)image.drxtune, LEN_DRX_TUNE_IMAGE);
+	writeBytes(DRX_TUNE, DRX_TUNE4H_SUB, (byte*)image.drxtune4H, LEN_DRX_TUNE4H);
 	writeBytes(LDE_IF, LDE_CFG1_SUB, ldecfg1, LEN_LDE_CFG1);
-	writeBytes(LDE_IF, LDE_CFG2_SUB, ldecfg2, LEN_LDE_CFG2);
-	writeBytes(LDE_IF, LDE_REPC_SUB, lderepc, LEN_LDE_REPC);
-	writeBytes(TX_POWER, NO_SUB, txpower, LEN_TX_POWER);
-	writeBytes(RF_CONF, RF_RXCTRLH_SUB, rfrxctrlh, LEN_RF_RXCTRLH);
-	writeBytes(RF_CONF, RF_TXCTRL_SUB, rftxctrl, LEN_RF_TXCTRL);
-	writeBytes(TX_CAL, TC_PGDELAY_SUB, tcpgdelay, LEN_TC_PGDELAY);
-	writeBytes(FS_CTRL, FS_PLLTUNE_SUB, fsplltune, LEN_FS_PLLTUNE);
-	writeBytes(FS_CTRL, FS_PLLCFG_SUB, fspllcfg, LEN_FS_PLLCFG);
-	writeBytes(FS_CTRL, FS_XTALT_SUB, fsxtalt, LEN_FS_XTALT);
+	writeBytes(LDE_IF, LDE_CFG2_SUB, (byte*)image.ldecfg2, LEN_LDE_CFG2);
+	writeBytes(LDE_IF, LDE_REPC_SUB, (byte*)image.lderepc, LEN_LDE_REPC);
+	writeBytes(TX_POWER, NO_SUB, (byte*)image.txpower, LEN_TX_POWER);
+	writeBytes(RF_CONF, RF_RXCTRLH_SUB, (byte*)image.rfconf, LEN_RF_CONF_IMAGE);
+	writeBytes(TX_CAL, TC_PGDELAY_SUB, (byte*)image.tcpgdelay, LEN_TC_PGDELAY);
+	writeBytes(FS_CTRL, FS_PLLCFG_SUB, (byte*)image.fspll, LEN_FS_PLL_IMAGE);
+	writeBytes(FS_CTRL, FS_XTALT_SUB, (byte*)image.fsxtalt, LEN_FS_XTALT);
+	// base values of the temperature and voltage compensation
+	memcpy(_txPowerTuned, image.txpower, LEN_TX_POWER);
+	_pgDelayTuned      = image.tcpgdelay[0];
+	_compensationDirty = true;
+}
+
+void DW1000Class::switchMode(const TuneImage& image) {
+	idle();
+	// take over the mode bits only, the rest of the registers belongs to other settings
+	setBit(_syscfg, LEN_SYS_CFG, RXM110K_BIT, getBit((byte*)image.syscfg, LEN_SYS_CFG, RXM110K_BIT));
+	memcpy(_chanctrl, image.chanctrl, LEN_CHAN_CTRL);
+	// data rate (byte 1), PRF, preamble length and extension (byte 2)
+	_txfctrl[1] = (_txfctrl[1] & 0x9F) | (image.txfctrl[1] & 0x60);
+	_txfctrl[2] = (_txfctrl[2] & 0xC0) | (image.txfctrl[2] & 0x3F);
+	_channel        = image.channel;
+	_dataRate       = image.dataRate;
+	_pulseFrequency = image.pulseFrequency;
+	_preambleLength = image.preambleLength;
+	_preambleCode   = image.preambleCode;
+	_pacSize        = image.pacSize;
+	writeSystemConfigurationRegister();
+	writeChannelControlRegister();
+	writeTransmitFrameControlRegister();
+	writeBytes(USR_SFD, SFD_LENGTH_SUB, (byte*)&image.sfdLength, LEN_SFD_LENGTH);
+	applyTuneImage(image);
+}
+
+void DW1000Class::getConfigSnapshot(ConfigSnapshot& snapshot) {
+	memset(&snapshot, 0, sizeof(ConfigSnapshot));
+	readBytes(EUI, NO_SUB, snapshot.eui, LEN_EUI);
+	memcpy(snapshot.networkAndAddress, _networkAndAddress, LEN_PANADR);
+	memcpy(snapshot.syscfg, _syscfg, LEN_SYS_CFG);
+	memcpy(snapshot.chanctrl, _chanctrl, LEN_CHAN_CTRL);
+	memcpy(snapshot.txfctrl, _txfctrl, LEN_TX_FCTRL);
+	memcpy(snapshot.sysmask, _sysmask, LEN_SYS_MASK);
+	writeValueToBytes(snapshot.antennaDelay, getAntennaDelay(), LEN_TX_ANTD);
+	snapshot.dataRate            = _dataRate;
+	snapshot.pulseFrequency      = _pulseFrequency;
+	snapshot.preambleLength      = _preambleLength;
+	snapshot.preambleCode        = _preambleCode;
+	snapshot.pacSize             = _pacSize;
+	snapshot.channel             = _channel;
+	snapshot.extendedFrameLength = _extendedFrameLength;
+	snapshot.frameCheck          = _frameCheck;
+	snapshot.smartPower          = _smartPower;
+	buildTuneImage(snapshot.tune);
+	// header
+	snapshot.magic   = CONFIG_SNAPSHOT_MAGIC;
+	snapshot.version = CONFIG_SNAPSHOT_VERSION;
+	snapshot.size    = sizeof(ConfigSnapshot);
+	snapshot.crc     = crc16(snapshot.eui, sizeof(ConfigSnapshot)-offsetof(ConfigSnapshot, eui));
+}
+
+boolean DW1000Class::isValidConfigSnapshot(const ConfigSnapshot& snapshot) {
+	if(snapshot.magic != CONFIG_SNAPSHOT_MAGIC || snapshot.version != CONFIG_SNAPSHOT_VERSION) {
+		return false;
+	}
+	if(snapshot.size != sizeof(ConfigSnapshot)) {
+		return false;
+	}
+	return snapshot.crc == crc16(snapshot.eui, sizeof(ConfigSnapshot)-offsetof(ConfigSnapshot, eui));
+}
+
+boolean DW1000Class::restoreConfigSnapshot(const ConfigSnapshot& snapshot) {
+	if(!isValidConfigSnapshot(snapshot)) {
+		return false;
+	}
+	idle();
+	// driver state
+	memcpy(_networkAndAddress, snapshot.networkAndAddress, LEN_PANADR);
+	memcpy(_syscfg, snapshot.syscfg, LEN_SYS_CFG);
+	memcpy(_chanctrl, snapshot.chanctrl, LEN_CHAN_CTRL);
+	memcpy(_txfctrl, snapshot.txfctrl, LEN_TX_FCTRL);
+	memcpy(_sysmask, snapshot.sysmask, LEN_SYS_MASK);
+	_dataRate            = snapshot.dataRate;
+	_pulseFrequency      = snapshot.pulseFrequency;
+	_preambleLength      = snapshot.preambleLength;
+	_preambleCode        = snapshot.preambleCode;
+	_pacSize             = snapshot.pacSize;
+	_channel             = snapshot.channel;
+	_extendedFrameLength = snapshot.extendedFrameLength;
+	_frameCheck          = snapshot.frameCheck;
+	_smartPower          = snapshot.smartPower;
+	_antennaDelay.setTimestamp((int64_t)snapshot.antennaDelay[0] | ((int64_t)snapshot.antennaDelay[1] << 8));
+	_antennaCalibrated   = true;
+	// chip
+	writeBytes(EUI, NO_SUB, (byte*)snapshot.eui, LEN_EUI);
+	writeNetworkIdAndDeviceAddress();
+	writeSystemConfigurationRegister();
+	writeChannelControlRegister();
+	writeTransmitFrameControlRegister();
+	writeSystemEventMaskRegister();
+	applyTuneImage(snapshot.tune);
+	_crystalTrim = snapshot.tune.fsxtalt[0] & FS_XTALT_MAX;
+	writeAntennaDelay();
+	return true;
+}
+
+uint16_t DW1000Class::crc16(const byte data[], uint16_t n, uint16_t crc) {
+	for(uint16_t i = 0; i < n; i++) {
+		crc ^= (uint16_t)data[i] << 8;
+		for(uint8_t b = 0; b < 8; b++) {
+			crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+		}
+	}
+	return crc;
+}
+
+// register files (or the documented parts of sparse ones) in a register snapshot, see user manual chapter 7
+struct RegisterBlock {
+	byte     file;
+	uint16_t offset;
+	uint16_t length;
+};
+
+static const RegisterBlock REGISTER_BLOCKS[] PROGMEM = {
+	{DEV_ID,     0x00,           4},
+	{EUI,        0x00,           8},
+	{PANADR,     0x00,           4},
+	{SYS_CFG,    0x00,           4},
+	{SYS_TIME,   0x00,           5},
+	{TX_FCTRL,   0x00,           5},
+	{DX_TIME,    0x00,           5},
+	{RX_FWTO,    0x00,           2},
+	{SYS_CTRL,   0x00,           4},
+	{SYS_MASK,   0x00,           4},
+	{SYS_STATUS, 0x00,           5},
+	{RX_FINFO,   0x00,           4},
+	{RX_FQUAL,   0x00,           8},
+	{RX_TTCKI,   0x00,           4},
+	{RX_TTCKO,   0x00,           5},
+	{RX_TIME,    0x00,           14},
+	{TX_TIME,    0x00,           10},
+	{TX_ANTD,    0x00,           2},
+	{SYS_STATE,  0x00,           5},
+	{ACK_RESP_T, 0x00,           4},
+	{RX_SNIFF,   0x00,           4},
+	{TX_POWER,   0x00,           4},
+	{CHAN_CTRL,  0x00,           4},
+	{USR_SFD,    0x00,           41},
+	{AGC_TUNE,   0x00,           33},
+	{EXT_SYNC,   0x00,           12},
+	{GPIO_CTRL,  0x00,           44},
+	{DRX_TUNE,   0x00,           44},
+	{RF_CONF,    0x00,           58},
+	{TX_CAL,     0x00,           52},
+	{FS_CTRL,    0x00,           21},
+	{AON,        0x00,           12},
+	{OTP_IF,     0x00,           18},
+	{LDE_IF,     LDE_THRESH_SUB, 2},
+	{LDE_IF,     LDE_CFG1_SUB,   1},
+	{LDE_IF,     LDE_PPINDX_SUB, 4},
+	{LDE_IF,     LDE_RXANTD_SUB, 4},
+	{LDE_IF,     LDE_REPC_SUB,   2},
+	{DIG_DIAG,   0x00,           41},
+	{PMSC,       0x00,           48}
+};
+
+static const byte REGISTER_SNAPSHOT_HEADER[] = {'R', 'E', 'G', 0x01};
+
+void DW1000Class::writeRegisterSnapshot(Print& out) {
+	const uint16_t numBlocks = sizeof(REGISTER_BLOCKS)/sizeof(RegisterBlock);
+	byte           buffer[5+REGISTER_SNAPSHOT_MAX_BLOCK];
+	out.write(REGISTER_SNAPSHOT_HEADER, sizeof(REGISTER_SNAPSHOT_HEADER));
+	writeValueToBytes(buffer, numBlocks, 2);
+	uint16_t crc = crc16(buffer, 2);
+	out.write(buffer, 2);
+	for(uint16_t i = 0; i < numBlocks; i++) {
+		RegisterBlock block;
+		memcpy_P(&block, &REGISTER_BLOCKS[i], sizeof(RegisterBlock));
+		buffer[0] = block.file;
+		writeValueToBytes(buffer+1, block.offset, 2);
+		writeValueToBytes(buffer+3, block.length, 2);
+		readBytes(block.file, block.offset, buffer+5, block.length);
+		crc = crc16(buffer, 5+block.length, crc);
+		out.write(buffer, 5+block.length);
+	}
+	writeValueToBytes(buffer, crc, 2);
+	out.write(buffer, 2);
+}
+
+uint16_t DW1000Class::getRegisterSnapshotSize() {
+	uint16_t size = sizeof(REGISTER_SNAPSHOT_HEADER)+2+2;
+	for(uint16_t i = 0; i < sizeof(REGISTER_BLOCKS)/sizeof(RegisterBlock); i++) {
+		size += 5+pgm_read_word(&REGISTER_BLOCKS[i].length);
+	}
+	return size;
 }
 
 /* ###########################################################################
@@ -907,18 +1002,190 @@ void DW1000Class::convertToByte(char string[], byte* bytes) {
 }
 
 void DW1000Class::getTempAndVbat(float& temp, float& vbat) {
+	startSarConversion();
+	readSarConversion(temp, vbat);
+}
+
+void DW1000Class::startSarConversion() {
 	// follow the procedure from section 6.4 of the User Manual
 	byte step1 = 0x80; writeBytes(RF_CONF, 0x11, &step1, 1);
 	byte step2 = 0x0A; writeBytes(RF_CONF, 0x12, &step2, 1);
 	byte step3 = 0x0F; writeBytes(RF_CONF, 0x12, &step3, 1);
-	byte step4 = 0x01; writeBytes(TX_CAL, NO_SUB, &step4, 1);
-	byte step5 = 0x00; writeBytes(TX_CAL, NO_SUB, &step5, 1);
-	byte sar_lvbat = 0; readBytes(TX_CAL, 0x03, &sar_lvbat, 1);
-	byte sar_ltemp = 0; readBytes(TX_CAL, 0x04, &sar_ltemp, 1);
+	byte step4 = 0x01; writeBytes(TX_CAL, TC_SARC, &step4, 1);
+}
+
+void DW1000Class::readSarConversion(float& temp, float& vbat) {
+	byte step5 = 0x00; writeBytes(TX_CAL, TC_SARC, &step5, 1);
+	// SAR_LVBAT and SAR_LTEMP in one burst
+	byte sar[LEN_TC_SARL];
+	readBytes(TX_CAL, TC_SARL, sar, LEN_TC_SARL);
 	
 	// calculate voltage and temperature
-	vbat = (sar_lvbat - _vmeas3v3) / 173.0f + 3.3f;
-	temp = (sar_ltemp - _tmeas23C) * 1.14f + 23.0f;
+	vbat = (sar[0] - _otpCalibration.vmeas3v3) / 173.0f + 3.3f;
+	temp = (sar[1] - _otpCalibration.tmeas23C) * 1.14f + 23.0f;
+}
+
+// neutral, the drift depends on the board, see setCompensationTables()
+static const DW1000Class::TempCompensation TEMP_COMPENSATION_DEFAULT[] PROGMEM = {
+	{23, 0, 0, 0}
+};
+static const DW1000Class::VbatCompensation VBAT_COMPENSATION_DEFAULT[] PROGMEM = {
+	{33, 0}
+};
+
+void DW1000Class::useTempAndVbatCompensation(boolean val, uint16_t intervalMs) {
+	_compensationInterval = intervalMs;
+	if(val == _compensationEnabled) {
+		return;
+	}
+	_compensationEnabled = val;
+	if(val) {
+		memset(&_compensationStatistics, 0, sizeof(CompensationStatistics));
+		_sarConverting    = false;
+		_compensationTime = millis()-intervalMs; // sample at the next update
+	} else {
+		// back to the tuned values
+		_compensationStatistics.txPowerOffset      = 0;
+		_compensationStatistics.pgDelayOffset      = 0;
+		_compensationStatistics.antennaDelayOffset = 0;
+		if(_compensationStatistics.samples > 0) {
+			applyCompensation(true);
+		}
+	}
+}
+
+void DW1000Class::setCompensationTables(const TempCompensation* temp, byte tempRows, const VbatCompensation* vbat, byte vbatRows) {
+	_tempCompensation     = temp;
+	_tempCompensationRows = temp == nullptr ? 0 : tempRows;
+	_vbatCompensation     = vbat;
+	_vbatCompensationRows = vbat == nullptr ? 0 : vbatRows;
+	_compensationDirty    = true;
+}
+
+boolean DW1000Class::updateCompensation() {
+	if(!_compensationEnabled) {
+		return false;
+	}
+	if(_sarConverting) {
+		if(micros()-_sarStartTime < TC_SAR_CONVERSION_US) {
+			return false;
+		}
+		float temp, vbat;
+		readSarConversion(temp, vbat);
+		_sarConverting = false;
+		noteCompensationSample(temp, vbat);
+		applyCompensation(false);
+		return true;
+	}
+	if(millis()-_compensationTime >= _compensationInterval) {
+		_compensationTime = millis();
+		startSarConversion();
+		_sarStartTime  = micros();
+		_sarConverting = true;
+	} else if(_compensationDirty && _compensationStatistics.samples > 0) {
+		// the chip has been tuned again meanwhile, the last sample is still good
+		applyCompensation(true);
+	}
+	return false;
+}
+
+void DW1000Class::noteCompensationSample(float temp, float vbat) {
+	CompensationStatistics& stats = _compensationStatistics;
+	if(stats.samples == 0) {
+		stats.minTemperature = stats.maxTemperature = temp;
+		stats.minVbat        = stats.maxVbat        = vbat;
+	} else {
+		stats.minTemperature = temp < stats.minTemperature ? temp : stats.minTemperature;
+		stats.maxTemperature = temp > stats.maxTemperature ? temp : stats.maxTemperature;
+		stats.minVbat        = vbat < stats.minVbat ? vbat : stats.minVbat;
+		stats.maxVbat        = vbat > stats.maxVbat ? vbat : stats.maxVbat;
+		// the samples are at least the interval apart, more if updateCompensation() is called late
+		uint32_t elapsed = _compensationTime-_compensationSampleTime;
+		if(elapsed > 0) {
+			float rate = (temp-stats.temperature)*60000.0f/elapsed;
+			stats.temperatureRate += (rate-stats.temperatureRate)/8;
+		}
+	}
+	_compensationSampleTime = _compensationTime;
+	stats.temperature = temp;
+	stats.vbat        = vbat;
+	stats.samples++;
+	
+	// offsets interpolated between the table rows
+	const TempCompensation* table = _tempCompensation != nullptr ? _tempCompensation : TEMP_COMPENSATION_DEFAULT;
+	byte rows = _tempCompensation != nullptr ? _tempCompensationRows : sizeof(TEMP_COMPENSATION_DEFAULT)/sizeof(TempCompensation);
+	TempCompensation lower, upper;
+	memcpy_P(&lower, &table[0], sizeof(TempCompensation));
+	upper = lower;
+	for(byte i = 1; i < rows && temp > lower.temperature; i++) {
+		memcpy_P(&upper, &table[i], sizeof(TempCompensation));
+		if(temp <= upper.temperature) {
+			break;
+		}
+		lower = upper;
+	}
+	float f = 0;
+	if(upper.temperature > lower.temperature && temp > lower.temperature) {
+		f = (temp-lower.temperature)/(upper.temperature-lower.temperature);
+		f = f > 1 ? 1 : f;
+	}
+	int8_t txPower      = (int8_t)round(lower.txPower+f*(upper.txPower-lower.txPower));
+	int8_t pgDelay      = (int8_t)round(lower.pgDelay+f*(upper.pgDelay-lower.pgDelay));
+	int8_t antennaDelay = (int8_t)round(lower.antennaDelay+f*(upper.antennaDelay-lower.antennaDelay));
+	// battery voltage, nearest row below (or the first one)
+	const VbatCompensation* vtable = _vbatCompensation != nullptr ? _vbatCompensation : VBAT_COMPENSATION_DEFAULT;
+	byte vrows = _vbatCompensation != nullptr ? _vbatCompensationRows : sizeof(VBAT_COMPENSATION_DEFAULT)/sizeof(VbatCompensation);
+	byte decivolts = vbat <= 0 ? 0 : (byte)(vbat*10+0.5f);
+	VbatCompensation row = {0, 0};
+	for(byte i = 0; i < vrows; i++) {
+		VbatCompensation next;
+		memcpy_P(&next, &vtable[i], sizeof(VbatCompensation));
+		if(i > 0 && next.vbat > decivolts) {
+			break;
+		}
+		row = next;
+	}
+	txPower += row.txPower;
+	
+	if(txPower != stats.txPowerOffset || pgDelay != stats.pgDelayOffset || antennaDelay != stats.antennaDelayOffset) {
+		stats.txPowerOffset      = txPower;
+		stats.pgDelayOffset      = pgDelay;
+		stats.antennaDelayOffset = antennaDelay;
+		stats.adjustments++;
+		_compensationDirty = true;
+	}
+}
+
+void DW1000Class::applyCompensation(boolean force) {
+	if(!_compensationDirty && !force) {
+		return;
+	}
+	const CompensationStatistics& stats = _compensationStatistics;
+	// fine gain only, the coarse steps of 3 dB are too large
+	byte txpower[LEN_TX_POWER];
+	for(uint8_t i = 0; i < LEN_TX_POWER; i++) {
+		int16_t fine = (_txPowerTuned[i] & TX_POWER_FINE_MASK)+stats.txPowerOffset;
+		fine = fine < 0 ? 0 : fine > TX_POWER_FINE_MAX ? TX_POWER_FINE_MAX : fine;
+		txpower[i] = (_txPowerTuned[i] & ~TX_POWER_FINE_MASK) | fine;
+	}
+	int16_t pgDelay = _pgDelayTuned+stats.pgDelayOffset;
+	byte    pgdelay = pgDelay < 0 ? 0 : pgDelay > 0xFF ? 0xFF : pgDelay;
+	writeBytes(TX_POWER, NO_SUB, txpower, LEN_TX_POWER);
+	writeBytes(TX_CAL, TC_PGDELAY_SUB, &pgdelay, LEN_TC_PGDELAY);
+	writeAntennaDelay();
+	_compensationDirty = false;
+}
+
+uint16_t DW1000Class::getCompensatedAntennaDelay() {
+	// the offset is 0 while the compensation is disabled
+	return getAntennaDelay()+_compensationStatistics.antennaDelayOffset;
+}
+
+void DW1000Class::writeAntennaDelay() {
+	byte antennaDelayBytes[LEN_TX_ANTD];
+	writeValueToBytes(antennaDelayBytes, getCompensatedAntennaDelay(), LEN_TX_ANTD);
+	writeBytes(TX_ANTD, NO_SUB, antennaDelayBytes, LEN_TX_ANTD);
+	writeBytes(LDE_IF, LDE_RXANTD_SUB, antennaDelayBytes, LEN_LDE_RXANTD);
 }
 
 void DW1000Class::setEUI(char eui[]) {
@@ -967,6 +1234,72 @@ void DW1000Class::setFrameFilterAllowReserved(boolean val) {
 	setBit(_syscfg, LEN_SYS_CFG, FFAR_BIT, val);
 }
 
+void DW1000Class::setFrameFilterPreset(byte preset) {
+	// the ranging protocol only uses data frames and blinks (reserved frame type)
+	setFrameFilterBehaveCoordinator(false);
+	setFrameFilterAllowBeacon(false);
+	setFrameFilterAllowAcknowledgement(false);
+	setFrameFilterAllowMAC(false);
+	if(preset == FRAME_FILTER_TAG) {
+		setFrameFilter(true);
+		setFrameFilterAllowData(true);
+		setFrameFilterAllowReserved(false);
+	} else if(preset == FRAME_FILTER_ANCHOR) {
+		setFrameFilter(true);
+		setFrameFilterAllowData(true);
+		setFrameFilterAllowReserved(true);
+	} else {
+		setFrameFilter(false);
+		setFrameFilterAllowData(false);
+		setFrameFilterAllowReserved(false);
+	}
+}
+
+boolean DW1000Class::isFrameFilterEnabled() {
+	return getBit(_syscfg, LEN_SYS_CFG, FFEN_BIT);
+}
+
+/* ###########################################################################
+ * #### Event counters #######################################################
+ * ######################################################################### */
+
+void DW1000Class::enableEventCounters(boolean val) {
+	byte evcctrl[LEN_EVC_CTRL];
+	memset(evcctrl, 0, LEN_EVC_CTRL);
+	setBit(evcctrl, LEN_EVC_CTRL, EVC_EN_BIT, val);
+	writeBytes(DIG_DIAG, EVC_CTRL_SUB, evcctrl, LEN_EVC_CTRL);
+}
+
+void DW1000Class::clearEventCounters() {
+	// counting goes on after the counters have been cleared
+	byte evcctrl[LEN_EVC_CTRL];
+	memset(evcctrl, 0, LEN_EVC_CTRL);
+	setBit(evcctrl, LEN_EVC_CTRL, EVC_EN_BIT, true);
+	setBit(evcctrl, LEN_EVC_CTRL, EVC_CLR_BIT, true);
+	writeBytes(DIG_DIAG, EVC_CTRL_SUB, evcctrl, LEN_EVC_CTRL);
+}
+
+void DW1000Class::getEventCounters(EventCounters& counters) {
+	// all counters are read in a single burst
+	byte evc[EVC_TPW_SUB+LEN_EVC-EVC_PHE_SUB];
+	readBytes(DIG_DIAG, EVC_PHE_SUB, evc, EVC_TPW_SUB+LEN_EVC-EVC_PHE_SUB);
+	uint16_t* fields[] = {
+		&counters.phrErrors, &counters.reedSolomonErrors, &counters.frameCheckGood,
+		&counters.frameCheckErrors, &counters.frameFilterRejections, &counters.overruns,
+		&counters.sfdTimeouts, &counters.preambleTimeouts, &counters.frameWaitTimeouts,
+		&counters.framesSent, &counters.halfPeriodWarnings, &counters.txPowerUpWarnings
+	};
+	for(uint8_t i = 0; i < sizeof(fields)/sizeof(fields[0]); i++) {
+		*fields[i] = (uint16_t)(evc[2*i] | ((uint16_t)evc[2*i+1] << 8)) & EVC_MASK;
+	}
+}
+
+uint16_t DW1000Class::getFrameFilterRejectCount() {
+	byte evc[LEN_EVC];
+	readBytes(DIG_DIAG, EVC_FFR_SUB, evc, LEN_EVC);
+	return (uint16_t)(evc[0] | ((uint16_t)evc[1] << 8)) & EVC_MASK;
+}
+
 
 void DW1000Class::setDoubleBuffering(boolean val) {
 	setBit(_syscfg, LEN_SYS_CFG, DIS_DRXB_BIT, !val);
@@ -1062,6 +1395,90 @@ void DW1000Class::startTransmit() {
 	}
 }
 
+void DW1000Class::startContinuousFrame(uint32_t repetitionPeriod) {
+	if(repetitionPeriod < 4) {
+		repetitionPeriod = 4;
+	}
+	// the sequencer would power the transmitter down after the first frame
+	disablePacketSequencing();
+	forceTransmitClocks();
+	// the repetition period replaces the delayed transmit time
+	byte dxtime[LEN_DX_TIME];
+	memset(dxtime, 0, LEN_DX_TIME);
+	writeValueToBytes(dxtime, repetitionPeriod, 4);
+	writeBytes(DX_TIME, NO_SUB, dxtime, LEN_DX_TIME);
+	// enable transmit power spectrum test mode
+	byte diagtmc[LEN_DIAG_TMC];
+	memset(diagtmc, 0, LEN_DIAG_TMC);
+	setBit(diagtmc, LEN_DIAG_TMC, TX_PSTM_BIT, true);
+	writeBytes(DIG_DIAG, DIAG_TMC_SUB, diagtmc, LEN_DIAG_TMC);
+	// start first transmission, the chip repeats it on its own
+	writeTransmitFrameControlRegister();
+	memset(_sysctrl, 0, LEN_SYS_CTRL);
+	setBit(_sysctrl, LEN_SYS_CTRL, SFCST_BIT, !_frameCheck);
+	setBit(_sysctrl, LEN_SYS_CTRL, TXSTRT_BIT, true);
+	writeBytes(SYS_CTRL, NO_SUB, _sysctrl, LEN_SYS_CTRL);
+	_deviceMode = TX_MODE;
+}
+
+void DW1000Class::startContinuousWave() {
+	idle();
+	disablePacketSequencing();
+	forceTransmitClocks();
+	// disable the fine grain transmit sequencing, so the power amplifier stays on
+	byte txfseq[LEN_PMSC_TXFSEQ];
+	memset(txfseq, 0, LEN_PMSC_TXFSEQ);
+	writeBytes(PMSC, PMSC_TXFSEQ_SUB, txfseq, LEN_PMSC_TXFSEQ);
+	writeByte(TX_CAL, TC_PGTEST_SUB, TC_PGTEST_CW);
+	_deviceMode = TX_MODE;
+}
+
+void DW1000Class::stopTestMode() {
+	writeByte(TX_CAL, TC_PGTEST_SUB, 0x00);
+	byte diagtmc[LEN_DIAG_TMC];
+	memset(diagtmc, 0, LEN_DIAG_TMC);
+	writeBytes(DIG_DIAG, DIAG_TMC_SUB, diagtmc, LEN_DIAG_TMC);
+	idle();
+	// back to automatic RF block and clock control, and (fine grain) packet sequencing
+	byte rfconf[LEN_RF_CONF];
+	memset(rfconf, 0, LEN_RF_CONF);
+	writeBytes(RF_CONF, NO_SUB, rfconf, LEN_RF_CONF);
+	byte txfseq[LEN_PMSC_TXFSEQ];
+	writeValueToBytes(txfseq, TXFSEQ_DEFAULT, LEN_PMSC_TXFSEQ);
+	writeBytes(PMSC, PMSC_TXFSEQ_SUB, txfseq, LEN_PMSC_TXFSEQ);
+	byte pmscctrl1[LEN_PMSC_CTRL1];
+	readBytes(PMSC, PMSC_CTRL1_SUB, pmscctrl1, LEN_PMSC_CTRL1);
+	pmscctrl1[0] = (pmscctrl1[0] & ~(byte)(PKTSEQ_MASK & 0xFF)) | (byte)(PKTSEQ_DEFAULT & 0xFF);
+	pmscctrl1[1] = (pmscctrl1[1] & ~(byte)(PKTSEQ_MASK >> 8)) | (byte)(PKTSEQ_DEFAULT >> 8);
+	writeBytes(PMSC, PMSC_CTRL1_SUB, pmscctrl1, 2);
+	enableClock(AUTO_CLOCK);
+}
+
+void DW1000Class::disablePacketSequencing() {
+	// the system clock has to run from the crystal while sequencing is changed
+	enableClock(XTI_CLOCK);
+	byte pmscctrl1[LEN_PMSC_CTRL1];
+	readBytes(PMSC, PMSC_CTRL1_SUB, pmscctrl1, LEN_PMSC_CTRL1);
+	pmscctrl1[0] &= ~(byte)(PKTSEQ_MASK & 0xFF);
+	pmscctrl1[1] &= ~(byte)(PKTSEQ_MASK >> 8);
+	writeBytes(PMSC, PMSC_CTRL1_SUB, pmscctrl1, 2);
+}
+
+void DW1000Class::forceTransmitClocks() {
+	// power up the PLLs first, then all transmitter blocks (including the transmitter itself)
+	byte rfconf[LEN_RF_CONF];
+	writeValueToBytes(rfconf, RF_CONF_TXPLLPOWEN, LEN_RF_CONF);
+	writeBytes(RF_CONF, NO_SUB, rfconf, LEN_RF_CONF);
+	writeValueToBytes(rfconf, RF_CONF_TXALLEN, LEN_RF_CONF);
+	writeBytes(RF_CONF, NO_SUB, rfconf, LEN_RF_CONF);
+	// clock system and transmitter from the PLL
+	enableClock(PLL_CLOCK);
+	byte pmscctrl0[LEN_PMSC_CTRL0];
+	readBytes(PMSC, PMSC_CTRL0_SUB, pmscctrl0, LEN_PMSC_CTRL0);
+	pmscctrl0[0] = 0x20 | (pmscctrl0[0] & 0xCF);
+	writeBytes(PMSC, PMSC_CTRL0_SUB, pmscctrl0, 1);
+}
+
 void DW1000Class::newConfiguration() {
 	idle();
 	readNetworkIdAndDeviceAddress();
@@ -1072,6 +1489,7 @@ void DW1000Class::newConfiguration() {
 }
 
 void DW1000Class::commitConfiguration() {
+	uint32_t since = micros();
 	// write all configurations back to device
 	writeNetworkIdAndDeviceAddress();
 	writeSystemConfigurationRegister();
@@ -1081,15 +1499,24 @@ void DW1000Class::commitConfiguration() {
 	// tune according to configuration
 	tune();
 	// TODO check not larger two bytes integer
-	byte antennaDelayBytes[DW1000Time::LENGTH_TIMESTAMP];
 	if( _antennaDelay.getTimestamp() == 0 && _antennaCalibrated == false) {
-		_antennaDelay.setTimestamp(16384);
+		// calibrated value from OTP if there is one
+		uint16_t otpDelay = (_pulseFrequency == TX_PULSE_FREQ_64MHZ ? _otpCalibration.antennaDelay64 : _otpCalibration.antennaDelay16);
+		_antennaDelay.setTimestamp(otpDelay != 0 ? otpDelay : 16384);
 		_antennaCalibrated = true;
 	} // Compatibility with old versions.
-	_antennaDelay.getTimestamp(antennaDelayBytes);
+	writeAntennaDelay();
+	_bootProfile.configure = bootPhase(since);
+}
 
-	writeBytes(TX_ANTD, NO_SUB, antennaDelayBytes, LEN_TX_ANTD);
-	writeBytes(LDE_IF, LDE_RXANTD_SUB, antennaDelayBytes, LEN_LDE_RXANTD);
+void DW1000Class::switchChannel(byte channel, byte preambleCode) {
+	idle();
+	setChannel(channel);
+	if(preambleCode != 0) {
+		setPreambleCode(preambleCode);
+	}
+	writeChannelControlRegister();
+	tune();
 }
 
 void DW1000Class::waitForResponse(boolean val) {
@@ -1122,9 +1549,9 @@ DW1000Time DW1000Class::setDelay(const DW1000Time& delay) {
 	delayBytes[0] = 0;
 	delayBytes[1] &= 0xFE;
 	writeBytes(DX_TIME, NO_SUB, delayBytes, LEN_DX_TIME);
-	// adjust expected time with configured antenna delay
+	// adjust expected time with the antenna delay in the chip (including the compensation)
 	futureTime.setTimestamp(delayBytes);
-	futureTime += _antennaDelay;
+	futureTime += DW1000Time((int64_t)getCompensatedAntennaDelay());
 	return futureTime;
 }
 
@@ -1207,6 +1634,40 @@ void DW1000Class::receivePermanently(boolean val) {
 		setReceiverAutoReenable(true);
 		writeSystemConfigurationRegister();
 	}
+	// (de-)activate low duty-cycle receive, only touch the chip on changes
+	boolean sniff = val && isSniffModeEnabled();
+	if(sniff || _sniffActive) {
+		writeSniffMode(sniff);
+	}
+}
+
+void DW1000Class::setSniffMode(byte onTimePacs, byte offTimeUs) {
+	// the chip adds one PAC to the on-time, so at least 2 PACs are used (see 7.2.40 user manual)
+	if(onTimePacs < 1) {
+		onTimePacs = 1;
+	}
+	_sniffOnTime  = onTimePacs & SNIFF_ONT_MASK;
+	_sniffOffTime = offTimeUs;
+}
+
+boolean DW1000Class::isSniffModeEnabled() {
+	return _sniffOffTime != 0;
+}
+
+void DW1000Class::writeSniffMode(boolean enable) {
+	// PLL2 sequencing is required to switch the receiver on and off (see 4.5.3 user manual)
+	byte pmscctrl0[LEN_PMSC_CTRL0];
+	readBytes(PMSC, PMSC_CTRL0_SUB, pmscctrl0, LEN_PMSC_CTRL0);
+	setBit(pmscctrl0, LEN_PMSC_CTRL0, PLL2_SEQ_EN_BIT, enable);
+	writeBytes(PMSC, PMSC_CTRL0_SUB, pmscctrl0, LEN_PMSC_CTRL0);
+	byte rxsniff[LEN_RX_SNIFF];
+	memset(rxsniff, 0, LEN_RX_SNIFF);
+	if(enable) {
+		rxsniff[0] = _sniffOnTime;
+		rxsniff[1] = _sniffOffTime;
+	}
+	writeBytes(RX_SNIFF, NO_SUB, rxsniff, LEN_RX_SNIFF);
+	_sniffActive = enable;
 }
 
 void DW1000Class::setChannel(byte channel) {
@@ -1239,6 +1700,10 @@ void DW1000Class::setChannel(byte channel) {
 	}
 }
 
+byte DW1000Class::getChannel() {
+	return _channel;
+}
+
 void DW1000Class::setPreambleCode(byte preacode) {
 	preacode &= 0x1F;
 	_chanctrl[2] &= 0x3F;
@@ -1248,6 +1713,10 @@ void DW1000Class::setPreambleCode(byte preacode) {
 	_preambleCode = preacode;
 }
 
+byte DW1000Class::getPreambleCode() {
+	return _preambleCode;
+}
+
 void DW1000Class::setDefaults() {
 	if(_deviceMode == TX_MODE) {
 		
@@ -1277,16 +1746,7 @@ void DW1000Class::setDefaults() {
 		setReceiverAutoReenable(true);
 		// default mode when powering up the chip
 		// still explicitly selected for later tuning
-		enableMode(MODE_LONGDATA_RANGE_LOWPOWER);
-		
-		// TODO add channel and code to mode tuples
-	    // TODO add channel and code settings with checks (see DW1000 user manual 10.5 table 61)/
-	    setChannel(CHANNEL_5);
-		if(getPulseFrequency() == TX_PULSE_FREQ_16MHZ) {
-			setPreambleCode(PREAMBLE_CODE_16MHZ_4);
-		} else {
-			setPreambleCode(PREAMBLE_CODE_64MHZ_10);
-		}
+		enableMode(PROFILE_LONGDATA_RANGE_LOWPOWER);
 	}
 }
 
@@ -1365,17 +1825,21 @@ void DW1000Class::getTransmitTimestamp(DW1000Time& time) {
 }
 
 void DW1000Class::getReceiveTimestamp(DW1000Time& time) {
-	byte rxTimeBytes[LEN_RX_STAMP];
-	readBytes(RX_TIME, RX_STAMP_SUB, rxTimeBytes, LEN_RX_STAMP);
-	time.setTimestamp(rxTimeBytes);
+	RxDiagnostics diag;
+	getReceiveDiagnostics(diag);
+	getReceiveTimestamp(diag, time);
+}
+
+void DW1000Class::getReceiveTimestamp(const RxDiagnostics& diag, DW1000Time& time) {
+	time.setTimestamp(diag.timestamp);
 	// correct timestamp (i.e. consider range bias)
-	correctTimestamp(time);
+	correctTimestamp(time, getReceivePower(diag));
 }
 
 // TODO check function, different type violations between byte and int
-void DW1000Class::correctTimestamp(DW1000Time& timestamp) {
+void DW1000Class::correctTimestamp(DW1000Time& timestamp, float rxPower) {
 	// base line dBm, which is -61, 2 dBm steps, total 18 data points (down to -95 dBm)
-	float rxPowerBase     = -(getReceivePower()+61.0f)*0.5f;
+	float rxPowerBase     = -(rxPower+61.0f)*0.5f;
 	int16_t   rxPowerBaseLow  = (int16_t)rxPowerBase; // TODO check type
 	int16_t   rxPowerBaseHigh = rxPowerBaseLow+1; // TODO check type
 	if(rxPowerBaseLow <= 0) {
@@ -1444,6 +1908,31 @@ void DW1000Class::getSystemTimestamp(byte data[]) {
 	readBytes(SYS_TIME, NO_SUB, data, LEN_SYS_TIME);
 }
 
+void DW1000Class::getTransmitTimestamp(DW1000Timestamp& time) {
+	byte txTimeBytes[LEN_TX_STAMP];
+	readBytes(TX_TIME, TX_STAMP_SUB, txTimeBytes, LEN_TX_STAMP);
+	time.setTimestamp(txTimeBytes);
+}
+
+void DW1000Class::getReceiveTimestamp(DW1000Timestamp& time) {
+	RxDiagnostics diag;
+	getReceiveDiagnostics(diag);
+	getReceiveTimestamp(diag, time);
+}
+
+void DW1000Class::getReceiveTimestamp(const RxDiagnostics& diag, DW1000Timestamp& time) {
+	DW1000Time corrected;
+	getReceiveTimestamp(diag, corrected);
+	// the range bias correction may cross the rollover
+	time = DW1000Timestamp(corrected);
+}
+
+void DW1000Class::getSystemTimestamp(DW1000Timestamp& time) {
+	byte sysTimeBytes[LEN_SYS_TIME];
+	readBytes(SYS_TIME, NO_SUB, sysTimeBytes, LEN_SYS_TIME);
+	time.setTimestamp(sysTimeBytes);
+}
+
 boolean DW1000Class::isTransmitDone() {
 	return getBit(_sysstatus, LEN_SYS_STATUS, TXFRS_BIT);
 }
@@ -1518,32 +2007,90 @@ void DW1000Class::clearTransmitStatus() {
 	writeBytes(SYS_STATUS, NO_SUB, _sysstatus, LEN_SYS_STATUS);
 }
 
+void DW1000Class::getReceiveDiagnostics(RxDiagnostics& diag) {
+	// the values are spread over three register files, a burst can not cross them
+	byte rxTime[FP_AMPL1_SUB+LEN_FP_AMPL1];
+	byte rxFrameQuality[LEN_RX_FQUAL];
+	byte rxFrameInfo[LEN_RX_FINFO];
+	byte carrierIntegrator[LEN_DRX_CAR_INT];
+	readBytes(RX_TIME, RX_STAMP_SUB, rxTime, FP_AMPL1_SUB+LEN_FP_AMPL1);
+	readBytes(RX_FQUAL, NO_SUB, rxFrameQuality, LEN_RX_FQUAL);
+	readBytes(RX_FINFO, NO_SUB, rxFrameInfo, LEN_RX_FINFO);
+	readBytes(DRX_TUNE, DRX_CAR_INT_SUB, carrierIntegrator, LEN_DRX_CAR_INT);
+	memcpy(diag.timestamp, rxTime+RX_STAMP_SUB, LEN_RX_STAMP);
+	diag.firstPathIndex       = (uint16_t)rxTime[FP_INDEX_SUB] | ((uint16_t)rxTime[FP_INDEX_SUB+1] << 8);
+	diag.firstPathAmplitude1  = (uint16_t)rxTime[FP_AMPL1_SUB] | ((uint16_t)rxTime[FP_AMPL1_SUB+1] << 8);
+	diag.noiseStdDeviation    = (uint16_t)rxFrameQuality[STD_NOISE_SUB] | ((uint16_t)rxFrameQuality[STD_NOISE_SUB+1] << 8);
+	diag.firstPathAmplitude2  = (uint16_t)rxFrameQuality[FP_AMPL2_SUB] | ((uint16_t)rxFrameQuality[FP_AMPL2_SUB+1] << 8);
+	diag.firstPathAmplitude3  = (uint16_t)rxFrameQuality[FP_AMPL3_SUB] | ((uint16_t)rxFrameQuality[FP_AMPL3_SUB+1] << 8);
+	diag.channelImpulsePower  = (uint16_t)rxFrameQuality[CIR_PWR_SUB] | ((uint16_t)rxFrameQuality[CIR_PWR_SUB+1] << 8);
+	diag.preambleAccumulation = (((uint16_t)rxFrameInfo[2] >> 4) & 0xFF) | ((uint16_t)rxFrameInfo[3] << 4);
+	// 21 bit signed
+	uint32_t integrator = bytesAsValue(carrierIntegrator, LEN_DRX_CAR_INT) & (((uint32_t)1 << (DRX_CAR_INT_SIGN_BIT+1))-1);
+	if(integrator & ((uint32_t)1 << DRX_CAR_INT_SIGN_BIT)) {
+		integrator |= ~(((uint32_t)1 << (DRX_CAR_INT_SIGN_BIT+1))-1);
+	}
+	diag.carrierIntegrator = (int32_t)integrator;
+}
+
+float DW1000Class::getClockOffset() {
+	RxDiagnostics diag;
+	getReceiveDiagnostics(diag);
+	return getClockOffset(diag);
+}
+
+float DW1000Class::getClockOffset(const RxDiagnostics& diag) {
+	float hertz = diag.carrierIntegrator * (_dataRate == TRX_RATE_110KBPS ? FREQ_OFFSET_MULTIPLIER_110KB : FREQ_OFFSET_MULTIPLIER);
+	// centre frequency of the channel in MHz, so the result is in ppm
+	float centre;
+	if(_channel == CHANNEL_1) {
+		centre = 3494.4f;
+	} else if(_channel == CHANNEL_2 || _channel == CHANNEL_4) {
+		centre = 3993.6f;
+	} else if(_channel == CHANNEL_3) {
+		centre = 4492.8f;
+	} else {
+		centre = 6489.6f;
+	}
+	return -hertz/centre;
+}
+
+void DW1000Class::setCrystalTrim(byte trim) {
+	if(trim > FS_XTALT_MAX) {
+		trim = FS_XTALT_MAX;
+	}
+	_crystalTrim = trim;
+	byte fsxtalt = trim | 0x60;
+	writeBytes(FS_CTRL, FS_XTALT_SUB, &fsxtalt, LEN_FS_XTALT);
+}
+
+byte DW1000Class::getCrystalTrim() {
+	return _crystalTrim;
+}
+
 float DW1000Class::getReceiveQuality() {
-	byte         noiseBytes[LEN_STD_NOISE];
-	byte         fpAmpl2Bytes[LEN_FP_AMPL2];
-	uint16_t     noise, f2;
-	readBytes(RX_FQUAL, STD_NOISE_SUB, noiseBytes, LEN_STD_NOISE);
-	readBytes(RX_FQUAL, FP_AMPL2_SUB, fpAmpl2Bytes, LEN_FP_AMPL2);
-	noise = (uint16_t)noiseBytes[0] | ((uint16_t)noiseBytes[1] << 8);
-	f2    = (uint16_t)fpAmpl2Bytes[0] | ((uint16_t)fpAmpl2Bytes[1] << 8);
-	return (float)f2/noise;
+	RxDiagnostics diag;
+	getReceiveDiagnostics(diag);
+	return getReceiveQuality(diag);
+}
+
+float DW1000Class::getReceiveQuality(const RxDiagnostics& diag) {
+	return (float)diag.firstPathAmplitude2/diag.noiseStdDeviation;
 }
 
 float DW1000Class::getFirstPathPower() {
-	byte         fpAmpl1Bytes[LEN_FP_AMPL1];
-	byte         fpAmpl2Bytes[LEN_FP_AMPL2];
-	byte         fpAmpl3Bytes[LEN_FP_AMPL3];
-	byte         rxFrameInfo[LEN_RX_FINFO];
+	RxDiagnostics diag;
+	getReceiveDiagnostics(diag);
+	return getFirstPathPower(diag);
+}
+
+float DW1000Class::getFirstPathPower(const RxDiagnostics& diag) {
 	uint16_t     f1, f2, f3, N;
 	float        A, corrFac;
-	readBytes(RX_TIME, FP_AMPL1_SUB, fpAmpl1Bytes, LEN_FP_AMPL1);
-	readBytes(RX_FQUAL, FP_AMPL2_SUB, fpAmpl2Bytes, LEN_FP_AMPL2);
-	readBytes(RX_FQUAL, FP_AMPL3_SUB, fpAmpl3Bytes, LEN_FP_AMPL3);
-	readBytes(RX_FINFO, NO_SUB, rxFrameInfo, LEN_RX_FINFO);
-	f1 = (uint16_t)fpAmpl1Bytes[0] | ((uint16_t)fpAmpl1Bytes[1] << 8);
-	f2 = (uint16_t)fpAmpl2Bytes[0] | ((uint16_t)fpAmpl2Bytes[1] << 8);
-	f3 = (uint16_t)fpAmpl3Bytes[0] | ((uint16_t)fpAmpl3Bytes[1] << 8);
-	N  = (((uint16_t)rxFrameInfo[2] >> 4) & 0xFF) | ((uint16_t)rxFrameInfo[3] << 4);
+	f1 = diag.firstPathAmplitude1;
+	f2 = diag.firstPathAmplitude2;
+	f3 = diag.firstPathAmplitude3;
+	N  = diag.preambleAccumulation;
 	if(_pulseFrequency == TX_PULSE_FREQ_16MHZ) {
 		A       = 113.77;
 		corrFac = 2.3334;
@@ -1562,15 +2109,17 @@ float DW1000Class::getFirstPathPower() {
 }
 
 float DW1000Class::getReceivePower() {
-	byte     cirPwrBytes[LEN_CIR_PWR];
-	byte     rxFrameInfo[LEN_RX_FINFO];
+	RxDiagnostics diag;
+	getReceiveDiagnostics(diag);
+	return getReceivePower(diag);
+}
+
+float DW1000Class::getReceivePower(const RxDiagnostics& diag) {
 	uint32_t twoPower17 = 131072;
 	uint16_t C, N;
 	float    A, corrFac;
-	readBytes(RX_FQUAL, CIR_PWR_SUB, cirPwrBytes, LEN_CIR_PWR);
-	readBytes(RX_FINFO, NO_SUB, rxFrameInfo, LEN_RX_FINFO);
-	C = (uint16_t)cirPwrBytes[0] | ((uint16_t)cirPwrBytes[1] << 8);
-	N = (((uint16_t)rxFrameInfo[2] >> 4) & 0xFF) | ((uint16_t)rxFrameInfo[3] << 4);
+	C = diag.channelImpulsePower;
+	N = diag.preambleAccumulation;
 	if(_pulseFrequency == TX_PULSE_FREQ_16MHZ) {
 		A       = 113.77;
 		corrFac = 2.3334;
@@ -1588,6 +2137,106 @@ float DW1000Class::getReceivePower() {
 	return estRxPwr;
 }
 
+/* ###########################################################################
+ * #### Accumulator (channel impulse response) ###############################
+ * ######################################################################### */
+
+uint16_t DW1000Class::getAccumulatorLength() {
+	if(_pulseFrequency == TX_PULSE_FREQ_16MHZ) {
+		return ACC_LENGTH_16MHZ;
+	}
+	return ACC_LENGTH_64MHZ;
+}
+
+uint16_t DW1000Class::getAccumulatorWindowStart(const RxDiagnostics& diag, uint16_t tapsBefore) {
+	// first path index is a 10.6 bit fixed point value
+	uint16_t firstPath = diag.firstPathIndex >> 6;
+	if(firstPath < tapsBefore) {
+		return 0;
+	}
+	return firstPath-tapsBefore;
+}
+
+void DW1000Class::getAccumulator(uint16_t firstTap, byte data[], uint16_t numTaps) {
+	enableAccumulatorClock(true);
+	readAccumulatorBytes(firstTap, data, numTaps);
+	enableAccumulatorClock(false);
+}
+
+void DW1000Class::getAccumulator(uint16_t firstTap, uint16_t numTaps, byte buffer[], uint16_t chunkTaps,
+                                 void (* handleChunk)(const byte data[], uint16_t firstTap, uint16_t numTaps)) {
+	uint16_t length = getAccumulatorLength();
+	if(chunkTaps == 0 || firstTap >= length) {
+		return;
+	}
+	if(numTaps > length-firstTap) {
+		numTaps = length-firstTap;
+	}
+	enableAccumulatorClock(true);
+	while(numTaps > 0) {
+		uint16_t n = (numTaps < chunkTaps ? numTaps : chunkTaps);
+		readAccumulatorBytes(firstTap, buffer, n);
+		if(handleChunk != 0) {
+			(*handleChunk)(buffer, firstTap, n);
+		}
+		firstTap += n;
+		numTaps  -= n;
+	}
+	enableAccumulatorClock(false);
+}
+
+void DW1000Class::enableAccumulatorClock(boolean val) {
+	// the accumulator memory needs the force accumulator clock (FACE) and the
+	// accumulator memory clock (AMCE) while reading, and the RX clock on the PLL
+	byte pmscctrl0[LEN_PMSC_CTRL0];
+	memset(pmscctrl0, 0, LEN_PMSC_CTRL0);
+	readBytes(PMSC, PMSC_CTRL0_SUB, pmscctrl0, LEN_PMSC_CTRL0);
+	if(val) {
+		pmscctrl0[0] = 0x48 | (pmscctrl0[0] & 0xB3);
+		pmscctrl0[1] |= 0x80;
+	} else {
+		pmscctrl0[0] &= 0xB3;
+		pmscctrl0[1] &= 0x7F;
+	}
+	writeBytes(PMSC, PMSC_CTRL0_SUB, pmscctrl0, 2);
+}
+
+void DW1000Class::readAccumulatorBytes(uint16_t firstTap, byte data[], uint16_t numTaps) {
+	uint16_t length = getAccumulatorLength();
+	if(firstTap >= length) {
+		return;
+	}
+	if(numTaps > length-firstTap) {
+		numTaps = length-firstTap;
+	}
+	// like readBytes(), but the first byte of an accumulator read is a dummy byte
+	uint16_t offset = firstTap*LEN_ACC_SAMPLE;
+	uint16_t n      = numTaps*LEN_ACC_SAMPLE;
+	byte header[3];
+	uint8_t headerLen = 2;
+	uint16_t i = 0;
+	header[0] = READ_SUB | ACC_MEM;
+	if(offset < 128) {
+		header[1] = (byte)offset;
+	} else {
+		header[1] = RW_SUB_EXT | (byte)offset;
+		header[2] = (byte)(offset >> 7);
+		headerLen++;
+	}
+	SPI.beginTransaction(*_currentSPI);
+	digitalWrite(_ss, LOW);
+	for(i = 0; i < headerLen; i++) {
+		SPI.transfer(header[i]); // send header
+	}
+	SPI.transfer(JUNK); // skip dummy byte
+	for(i = 0; i < n; i++) {
+		data[i] = SPI.transfer(JUNK); // read values
+	}
+	delayMicroseconds(5);
+	digitalWrite(_ss, HIGH);
+	SPI.endTransaction();
+}
+
 /* ###########################################################################
  * #### Helper functions #####################################################
  * ######################################################################### */
@@ -1652,6 +2301,14 @@ void DW1000Class::writeValueToBytes(byte data[], int32_t val, uint16_t n) {
 	}
 }
 
+uint32_t DW1000Class::bytesAsValue(const byte data[], uint16_t n) {
+	uint32_t value = 0;
+	for(uint16_t i = n; i > 0; i--) {
+		value = (value << 8) | data[i-1];
+	}
+	return value;
+}
+
 /*
  * Read bytes from the DW1000. Number of bytes depend on register length.
  * @param cmd
@@ -1694,22 +2351,32 @@ void DW1000Class::readBytes(byte cmd, uint16_t offset, byte data[], uint16_t n)
 	SPI.endTransaction();
 }
 
-// always 4 bytes
+boolean DW1000Class::waitForBits(byte cmd, uint16_t offset, uint32_t mask, uint32_t value, uint16_t timeoutUs) {
+	byte     data[4];
+	uint32_t start = micros();
+	do {
+		readBytes(cmd, offset, data, 4);
+		if((bytesAsValue(data, 4) & mask) == value) {
+			return true;
+		}
+	} while(micros()-start < timeoutUs);
+	return false;
+}
+
+// consecutive words, always 4 bytes each
 // TODO why always 4 bytes? can be different, see p. 58 table 10 otp memory map
-void DW1000Class::readBytesOTP(uint16_t address, byte data[]) {
-	byte addressBytes[LEN_OTP_ADDR];
-	
+void DW1000Class::readBytesOTP(uint16_t address, byte data[], uint8_t words) {
 	// p60 - 6.3.3 Reading a value from OTP memory
-	// bytes of address
-	addressBytes[0] = (address & 0xFF);
-	addressBytes[1] = ((address >> 8) & 0xFF);
-	// set address
-	writeBytes(OTP_IF, OTP_ADDR_SUB, addressBytes, LEN_OTP_ADDR);
-	// switch into read mode
-	writeByte(OTP_IF, OTP_CTRL_SUB, 0x03); // OTPRDEN | OTPREAD
-	writeByte(OTP_IF, OTP_CTRL_SUB, 0x01); // OTPRDEN
-	// read value/block - 4 bytes
-	readBytes(OTP_IF, OTP_RDAT_SUB, data, LEN_OTP_RDAT);
+	// address (OTP_ADDR) and control (OTP_CTRL) are adjacent, so one write sets the address and starts reading
+	byte request[LEN_OTP_ADDR+1];
+	for(uint8_t i = 0; i < words; i++) {
+		request[0] = ((address+i) & 0xFF);
+		request[1] = (((address+i) >> 8) & 0xFF);
+		request[2] = 0x03; // OTPRDEN | OTPREAD (OTPREAD clears itself)
+		writeBytes(OTP_IF, OTP_ADDR_SUB, request, LEN_OTP_ADDR+1);
+		// read value/block - 4 bytes
+		readBytes(OTP_IF, OTP_RDAT_SUB, data+i*LEN_OTP_RDAT, LEN_OTP_RDAT);
+	}
 	// end read mode
 	writeByte(OTP_IF, OTP_CTRL_SUB, 0x00);
 }
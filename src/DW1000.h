@@ -30,11 +30,14 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stddef.h>
 #include <string.h>
 #include <Arduino.h>
 #include <SPI.h>
 #include "DW1000Constants.h"
 #include "DW1000Time.h"
+#include "DW1000Timestamp.h"
+#include "DW1000Profile.h"
 
 class DW1000Class {
 public:
@@ -91,14 +94,44 @@ public:
 	static void setGPIOMode(uint8_t msgp, uint8_t mode);
 
         /**
-        Enable deep sleep mode
+        Enable deep sleep mode. The configuration is saved to the always-on (AON) memory and
+        restored on wake-up together with the LDE microcode, see `spiWakeup()`.
         */
         static void deepSleep();
 
         /**
-        Wake-up from deep sleep by toggle chip select pin
+        Wake-up from deep sleep by toggle chip select pin. Waits until the chip is ready again and
+        reconciles it with the driver state instead of a complete `select()`: the receiver antenna
+        delay (not kept in AON) is rewritten, and only if the restored configuration does not match
+        the driver's copy, the configuration is written completely.
+
+        @return `true` if the chip was ready in time.
+        */
+        static boolean spiWakeup();
+
+        /**
+        Time from the start of the last `spiWakeup()` until the chip was ready, in microseconds.
         */
-        static void spiWakeup();
+        static uint32_t getWakeLatency() { return _wakeLatency; }
+
+	/** 
+	Durations of the start up phases of the last `select()` in microseconds. Instead of waiting fixed
+	worst case times, `select()` polls the chip status (device id readable, clock PLL locked,
+	LDE microcode loaded), so the values show how long the chip actually needed. `configure` is the
+	time of the last `commitConfiguration()`, the remaining chip work of a start.
+	*/
+	struct BootProfile {
+		uint16_t wakeup;    // until the chip answered on SPI
+		uint16_t reset;     // reset until the clock PLL locked again
+		uint16_t setup;     // default register configuration
+		uint16_t lde;       // loading the LDE microcode and switching back to the PLL clock
+		uint16_t otp;       // reading calibration values from OTP
+		uint32_t total;     // the whole select()
+		uint16_t configure; // the last commitConfiguration() (e.g. in DW1000Ranging.startAsAnchor())
+		byte     timeouts;  // status polls that ran into their (worst case) timeout
+	};
+	
+	static const BootProfile& getBootProfile() { return _bootProfile; }
 
 	/**
 	Resets all connected or the currently selected DW1000 chip. A hard reset of all chips
@@ -166,11 +199,75 @@ public:
 	@param[in] val An arbitrary numeric device address.
 	*/
 	static void setDeviceAddress(uint16_t val);
-	// TODO MAC and filters
 	
 	static void setEUI(char eui[]);
 	static void setEUI(byte eui[]);
 	
+	/** 
+	Enables or disables hardware (MAC) frame filtering. If enabled, the chip only accepts frames whose
+	destination PAN identifier and address match the ones set with `setNetworkId()`, `setDeviceAddress()`
+	and `setEUI()` (or are broadcast), and whose frame type has been allowed with one of the
+	`setFrameFilterAllow...()` calls. Rejected frames neither raise an interrupt nor have to be read.
+
+	Frame filtering is disabled as part of `setDefaults()` if the device is in idle mode.
+
+	@param[in] val `true` to enable, `false` to disable frame filtering.
+	*/
+	static void setFrameFilter(boolean val);
+	static void setFrameFilterBehaveCoordinator(boolean val);
+	static void setFrameFilterAllowBeacon(boolean val);
+	//data type is used in the FC_1 0x41
+	static void setFrameFilterAllowData(boolean val);
+	static void setFrameFilterAllowAcknowledgement(boolean val);
+	static void setFrameFilterAllowMAC(boolean val);
+	//Reserved is used for the Blink message
+	static void setFrameFilterAllowReserved(boolean val);
+	static boolean isFrameFilterEnabled();
+	
+	/** 
+	Applies a frame filter configuration that fits a role in the ranging protocol. One of
+	- `FRAME_FILTER_NONE` (frame filtering disabled, every frame is received)
+	- `FRAME_FILTER_TAG` (data frames to our PAN and address or broadcast)
+	- `FRAME_FILTER_ANCHOR` (like `FRAME_FILTER_TAG`, plus blink frames)
+	has to be provided. Like all other configuration settings it is written to the chip
+	by `commitConfiguration()`.
+
+	@param[in] preset The frame filter configuration, encoded by the above defined constants.
+	*/
+	static void setFrameFilterPreset(byte preset);
+	
+	/* ##### Event counters ###################################################### */
+	/** 
+	Counts of receiver and transmitter events since the counters have been enabled or
+	cleared. Each counter is 12 bits wide and saturates at 4095.
+	*/
+	struct EventCounters {
+		uint16_t phrErrors;
+		uint16_t reedSolomonErrors;
+		uint16_t frameCheckGood;
+		uint16_t frameCheckErrors;
+		uint16_t frameFilterRejections;
+		uint16_t overruns;
+		uint16_t sfdTimeouts;
+		uint16_t preambleTimeouts;
+		uint16_t frameWaitTimeouts;
+		uint16_t framesSent;
+		uint16_t halfPeriodWarnings;
+		uint16_t txPowerUpWarnings;
+	};
+	
+	/** 
+	Enables or disables the event counters of the chip (e.g. the number of frames dropped
+	by the frame filter). Counters are disabled after power up and reset.
+
+	@param[in] val `true` to enable, `false` to disable the event counters.
+	*/
+	static void enableEventCounters(boolean val);
+	static void clearEventCounters();
+	static void getEventCounters(EventCounters& counters);
+	// number of frames that were dropped by the hardware frame filter
+	static uint16_t getFrameFilterRejectCount();
+	
 	/* ##### General device configuration ######################################## */
 	/** 
 	Specifies whether the DW1000 chip should, again, turn on its receiver in case that the
@@ -237,12 +334,29 @@ public:
 	static byte getPulseFrequency();
 	static void setPreambleLength(byte prealen);
 	static void setChannel(byte channel);
+	static byte getChannel();
 	static void setPreambleCode(byte preacode);
+	static byte getPreambleCode();
 	static void useSmartPower(boolean smartPower);
 	
 	/* transmit and receive configuration. */
 	static DW1000Time   setDelay(const DW1000Time& delay);
 	static void         receivePermanently(boolean val);
+
+	/**
+	Configures the low duty-cycle SNIFF mode of the receiver. Instead of hunting for a preamble
+	continuously, the receiver is switched on for `onTimePacs` (+1) PAC sizes and switched off for
+	`offTimeUs` (approx. microseconds) in turns, until a preamble is detected. A preamble has to be
+	longer than one off-phase plus one on-phase to be reliably detected.
+
+	The setting is applied on the next call to `receivePermanently(true)`; a call to
+	`receivePermanently(false)` switches SNIFF mode off again. An `offTimeUs` of 0 disables SNIFF mode.
+
+	@param[in] onTimePacs On-phase in multiples of the PAC size (1 to 15, the chip adds one PAC).
+	@param[in] offTimeUs Off-phase in approx. microseconds (0 to 255).
+	*/
+	static void         setSniffMode(byte onTimePacs, byte offTimeUs);
+	static boolean      isSniffModeEnabled();
 	static void         setData(byte data[], uint16_t n);
 	static void         setData(const String& data);
 	static void         getData(byte data[], uint16_t n);
@@ -254,12 +368,106 @@ public:
 	static void         getTransmitTimestamp(byte data[]);
 	static void         getReceiveTimestamp(byte data[]);
 	static void         getSystemTimestamp(byte data[]);
+	static void         getTransmitTimestamp(DW1000Timestamp& time);
+	static void         getReceiveTimestamp(DW1000Timestamp& time);
+	static void         getSystemTimestamp(DW1000Timestamp& time);
 	
 	/* receive quality information. */
 	static float getReceivePower();
 	static float getFirstPathPower();
 	static float getReceiveQuality();
 	
+	/** 
+	Raw receive diagnostics of the last received frame, i.e. the (uncorrected) receive timestamp
+	and all values the receive power, first path power, quality and timestamp correction are
+	computed from. Use it instead of the single getters if more than one of them is needed per frame.
+	*/
+	struct RxDiagnostics {
+		byte     timestamp[LEN_RX_STAMP];
+		uint16_t firstPathIndex;
+		uint16_t firstPathAmplitude1;
+		uint16_t firstPathAmplitude2;
+		uint16_t firstPathAmplitude3;
+		uint16_t noiseStdDeviation;
+		uint16_t channelImpulsePower;
+		uint16_t preambleAccumulation;
+		int32_t  carrierIntegrator;
+	};
+	
+	/** 
+	Fills the receive diagnostics of the last received frame with one burst read
+	per register file (RX_TIME, RX_FQUAL, RX_FINFO and the carrier integrator of DRX_CONF).
+
+	@param[out] diag The receive diagnostics to be filled.
+	*/
+	static void  getReceiveDiagnostics(RxDiagnostics& diag);
+	static float getReceivePower(const RxDiagnostics& diag);
+	static float getFirstPathPower(const RxDiagnostics& diag);
+	static float getReceiveQuality(const RxDiagnostics& diag);
+	static void  getReceiveTimestamp(const RxDiagnostics& diag, DW1000Time& time);
+	static void  getReceiveTimestamp(const RxDiagnostics& diag, DW1000Timestamp& time);
+	
+	/** 
+	Clock offset between the sender of the last received frame and this chip, estimated from the
+	carrier integrator of the receiver. Positive values mean the sender's clock runs faster.
+
+	@return The clock offset in ppm.
+	*/
+	static float getClockOffset();
+	static float getClockOffset(const RxDiagnostics& diag);
+	
+	/** 
+	Adjusts the crystal oscillator trim (FS_XTALT), e.g. to reduce the clock offset to a reference device.
+	Higher values lower the clock frequency, one step is about 1.5 ppm. At start the value calibrated in
+	production (OTP) is used, or the middle of the range if there is none.
+
+	@param[in] trim The trim value, 0 to `FS_XTALT_MAX`.
+	*/
+	static void setCrystalTrim(byte trim);
+	static byte getCrystalTrim();
+	
+	/* ##### Accumulator (channel impulse response) ############################# */
+	/** 
+	Number of accumulator taps (i.e. channel impulse response samples) available with the current
+	pulse repetition frequency, 992 for 16 MHz and 1016 for 64 MHz PRF. Each tap is about 1 ns long.
+	*/
+	static uint16_t getAccumulatorLength();
+	
+	/** 
+	First accumulator tap of a window of `tapsBefore` taps before the first path of the last
+	received frame, as found by the leading edge detection.
+
+	@param[in] diag The receive diagnostics of the frame (see `getReceiveDiagnostics()`).
+	@param[in] tapsBefore Number of taps the window should start before the first path.
+	*/
+	static uint16_t getAccumulatorWindowStart(const RxDiagnostics& diag, uint16_t tapsBefore);
+	
+	/** 
+	Reads taps of the accumulator (channel impulse response) of the last received frame. Each tap is
+	delivered as `LEN_ACC_SAMPLE` bytes: 16 bit signed real and 16 bit signed imaginary part, little endian.
+	The receiver must not be re-enabled before reading is done, otherwise the next frame overwrites
+	the accumulator (i.e. do not use `receivePermanently(true)` while reading).
+
+	@param[in] firstTap The first tap to read.
+	@param[out] data The buffer for the taps, `numTaps * LEN_ACC_SAMPLE` bytes.
+	@param[in] numTaps The number of taps to read.
+	*/
+	static void getAccumulator(uint16_t firstTap, byte data[], uint16_t numTaps);
+	
+	/** 
+	Like `getAccumulator(uint16_t, byte[], uint16_t)`, but reads an arbitrary long range of taps
+	in chunks of at most `chunkTaps` taps through the given buffer, e.g. to stream the full impulse
+	response on boards with little RAM. The handler is called for every chunk read.
+
+	@param[in] firstTap The first tap to read.
+	@param[in] numTaps The number of taps to read.
+	@param[in] buffer The buffer used for each chunk, `chunkTaps * LEN_ACC_SAMPLE` bytes.
+	@param[in] chunkTaps The number of taps fitting into the buffer.
+	@param[in] handleChunk The handler receiving each chunk with the number of its first tap.
+	*/
+	static void getAccumulator(uint16_t firstTap, uint16_t numTaps, byte buffer[], uint16_t chunkTaps,
+	                           void (* handleChunk)(const byte data[], uint16_t firstTap, uint16_t numTaps));
+	
 	/* interrupt management. */
 	static void interruptOnSent(boolean val);
 	static void interruptOnReceived(boolean val);
@@ -305,6 +513,16 @@ public:
 	static void newConfiguration();
 	static void commitConfiguration();
 	
+	/** 
+	Moves the chip to another channel without a full `newConfiguration()`/`commitConfiguration()`
+	cycle: only the channel control register and the channel dependent tuning are written, e.g. to
+	hop channels between ranging rounds. The chip is left in idle mode.
+
+	@param[in] channel The new channel (see `setChannel()`).
+	@param[in] preambleCode The preamble code to use on the new channel, 0 picks the default one.
+	*/
+	static void switchChannel(byte channel, byte preambleCode = 0);
+	
 	// reception state
 	static void newReceive();
 	static void startReceive();
@@ -313,7 +531,88 @@ public:
 	static void newTransmit();
 	static void startTransmit();
 	
+	/* ##### Test modes ########################################################## */
+	/** 
+	Starts sending the frame that has been set with `setData()` again and again in continuous frame
+	test mode, e.g. for regulatory or range tests. Has to be called after `newTransmit()` and `setData()`
+	instead of `startTransmit()`. No sent interrupts are generated. If the repetition period is shorter
+	than the frame duration, frames are sent back-to-back.
+
+	@param[in] repetitionPeriod Frame start to frame start period in units of ~8 ns (1/124.8 MHz),
+		e.g. 124800 for one frame per millisecond. Minimum is 4.
+	*/
+	static void startContinuousFrame(uint32_t repetitionPeriod);
+	
+	/** 
+	Starts transmitting an unmodulated continuous wave on the center frequency of the configured
+	channel, e.g. for regulatory tests or crystal trimming.
+	*/
+	static void startContinuousWave();
+	
+	/** 
+	Stops the continuous frame or continuous wave test mode and returns to idle mode. The
+	configuration of the chip is kept.
+	*/
+	static void stopTestMode();
+	
 	/* ##### Operation mode selection ############################################ */
+	/** 
+	Register values of a mode of operation: the registers that select it (channel, preamble code,
+	PRF, data rate, preamble length and SFD) and the ones the chip is tuned with (see `tune()`),
+	grouped by blocks of consecutive registers so that each block can be written with one burst.
+	The driver state of the mode is kept along, see `switchMode()`.
+	*/
+	struct TuneImage {
+		byte syscfg[LEN_SYS_CFG];
+		byte chanctrl[LEN_CHAN_CTRL];
+		byte txfctrl[LEN_TX_FCTRL];
+		byte sfdLength;
+		byte channel;
+		byte dataRate;
+		byte pulseFrequency;
+		byte preambleLength;
+		byte preambleCode;
+		byte pacSize;
+		byte agctune1[LEN_AGC_TUNE1];
+		byte drxtune[LEN_DRX_TUNE_IMAGE]; // DRX_TUNE0b, DRX_TUNE1a, DRX_TUNE1b, DRX_TUNE2
+		byte drxtune4H[LEN_DRX_TUNE4H];
+		byte ldecfg2[LEN_LDE_CFG2];
+		byte lderepc[LEN_LDE_REPC];
+		byte txpower[LEN_TX_POWER];
+		byte rfconf[LEN_RF_CONF_IMAGE]; // RF_RXCTRLH, RF_TXCTRL
+		byte tcpgdelay[LEN_TC_PGDELAY];
+		byte fspll[LEN_FS_PLL_IMAGE]; // FS_PLLCFG, FS_PLLTUNE
+		byte fsxtalt[LEN_FS_XTALT];
+	};
+	
+	/** 
+	Assembles the register values of the current mode (see `enableMode()`) and the tuning register values
+	from the tables in flash. Together with `switchMode()` this allows to prepare images of several modes
+	once and switch between them quickly, e.g. between ranging rounds.
+
+	@param[out] image The register values to be filled.
+	*/
+	static void buildTuneImage(TuneImage& image);
+	
+	/** 
+	Writes only the tuning register values of an image to the chip (one burst per block of consecutive
+	registers). Note that the general configuration (see `commitConfiguration()`) has to match the image,
+	use `switchMode()` to change the mode.
+
+	@param[in] image The register values, see `buildTuneImage()`.
+	*/
+	static void applyTuneImage(const TuneImage& image);
+	
+	/** 
+	Switches to the mode of an image that has been prepared with `buildTuneImage()`, without a complete
+	`commitConfiguration()`: the channel, preamble code, PRF, data rate and preamble length are written
+	along with the tuning registers, and the driver state (e.g. `getChannel()`, `getPreambleCode()`) follows.
+	Other settings (addresses, frame filter, smart power, ...) stay as they are. The chip is left in idle mode.
+
+	@param[in] image The mode to switch to, see `buildTuneImage()`.
+	*/
+	static void switchMode(const TuneImage& image);
+
 	/** 
 	Specifies the mode of operation for the DW1000. Modes of operation are pre-defined
 	combinations of data rate, pulse repetition frequency, preamble and channel settings
@@ -337,9 +636,108 @@ public:
 	*/
 	static void enableMode(const byte mode[]);
 	
+	/** 
+	Specifies the complete radio configuration (channel, pulse repetition frequency, preamble code and
+	length, PAC size, SFD and data rate) in one step. Other than with `enableMode(const byte[])`, channel and
+	preamble code are part of the configuration and the combination of settings has been validated
+	(at compile time for `constexpr` profiles, see `DW1000Profile`). A profile built at run time that
+	did not pass the validation is not applied.
+
+	The following profiles are pre-defined, they match the modes above on channel 5:
+	- `PROFILE_LONGDATA_RANGE_LOWPOWER`
+	- `PROFILE_SHORTDATA_FAST_LOWPOWER`
+	- `PROFILE_LONGDATA_FAST_LOWPOWER`
+	- `PROFILE_SHORTDATA_FAST_ACCURACY`
+	- `PROFILE_LONGDATA_FAST_ACCURACY`
+	- `PROFILE_LONGDATA_RANGE_ACCURACY`
+
+	@param[in] profile The radio configuration.
+	@return `false` if the profile is invalid (see `DW1000Profile::isValid()`), nothing has been changed then.
+	*/
+	static boolean enableMode(const DW1000Profile& profile);
+	
 	// use RX/TX specific and general default settings
 	static void setDefaults();
 	
+	/* ##### Configuration snapshots ############################################# */
+	/** 
+	The complete configuration as one flat block of bytes (shadow registers, EUI, antenna delay,
+	mode settings and tune image), e.g. to be stored in EEPROM or flash and restored at the next start.
+	The header (magic, layout version, size and CRC-16 over the rest) rejects stale or corrupted snapshots.
+	*/
+	struct ConfigSnapshot {
+		uint16_t  magic;
+		uint16_t  version;
+		uint16_t  size;
+		uint16_t  crc;
+		byte      eui[LEN_EUI];
+		byte      networkAndAddress[LEN_PANADR];
+		byte      syscfg[LEN_SYS_CFG];
+		byte      chanctrl[LEN_CHAN_CTRL];
+		byte      txfctrl[LEN_TX_FCTRL];
+		byte      sysmask[LEN_SYS_MASK];
+		byte      antennaDelay[LEN_TX_ANTD];
+		byte      dataRate;
+		byte      pulseFrequency;
+		byte      preambleLength;
+		byte      preambleCode;
+		byte      pacSize;
+		byte      channel;
+		byte      extendedFrameLength;
+		byte      frameCheck;
+		byte      smartPower;
+		TuneImage tune;
+	};
+	
+	/** 
+	Captures the current (committed) configuration of the selected chip.
+
+	@param[out] snapshot The configuration, with a valid header.
+	*/
+	static void getConfigSnapshot(ConfigSnapshot& snapshot);
+	
+	/** 
+	Checks magic, version, size and CRC of a snapshot, e.g. one that has been loaded from EEPROM.
+
+	@param[in] snapshot The snapshot to check.
+	@return `true` if the snapshot can be restored.
+	*/
+	static boolean isValidConfigSnapshot(const ConfigSnapshot& snapshot);
+	
+	/** 
+	Restores a configuration that has been captured with `getConfigSnapshot()`, instead of rebuilding it with
+	`newConfiguration()` ... `commitConfiguration()`: all registers are written with burst writes, nothing is
+	read back or recomputed. Has to be called after `select()`, the chip is left in idle mode.
+
+	@param[in] snapshot The configuration to restore.
+	@return `false` (and the chip untouched) if the snapshot is invalid, see `isValidConfigSnapshot()`.
+	*/
+	static boolean restoreConfigSnapshot(const ConfigSnapshot& snapshot);
+	
+	/** 
+	CRC-16/CCITT (initial value 0xFFFF) as used for configuration snapshots and calibration records.
+	Pass the result of the previous call as `crc` to continue over several blocks of data.
+	*/
+	static uint16_t crc16(const byte data[], uint16_t n, uint16_t crc = 0xFFFF);
+	
+	/* ##### Register snapshots ################################################## */
+	/** 
+	Burst-reads every documented register file (except the buffers and the accumulator) and streams
+	the raw contents as one binary image, e.g. to Serial. Decode and compare images on the host
+	with `extras/tools/reg_diff.py`. Format (little endian):
+
+	    "REG" version(1) blocks(2)  { file(1) offset(2) length(2) data(length) } x blocks  crc16(2)
+
+	The CRC-16 covers everything after the magic. Frames that are received or sent at the same
+	time may change the event related registers while they are read.
+
+	@param[out] out Where to write the image.
+	*/
+	static void writeRegisterSnapshot(Print& out);
+	
+	// size of the image written by `writeRegisterSnapshot()` [bytes]
+	static uint16_t getRegisterSnapshotSize();
+	
 	/* debug pretty print registers. */
 	static void getPrettyBytes(byte cmd, uint16_t offset, char msgBuffer[], uint16_t n);
 	static void getPrettyBytes(byte data[], char msgBuffer[], uint16_t n);
@@ -348,9 +746,90 @@ public:
 	static uint8_t nibbleFromChar(char c);
 	static void convertToByte(char string[], byte* eui_byte);
 	
+	/** 
+	Calibration values from the chip's OTP memory (programmed during production test), loaded once by `select()`.
+	LDO tune and crystal trim are applied automatically, the antenna delay of the used PRF replaces the
+	default one unless `setAntennaDelay()` has been called. Values that have not been programmed are 0.
+	*/
+	struct OtpCalibration {
+		byte     ldoTune[LEN_OTP_LDOTUNE];
+		uint32_t partId;
+		uint32_t lotId;
+		byte     vmeas3v3;       // SAR reading of the battery voltage at 3.3 V
+		byte     tmeas23C;       // SAR reading of the temperature at 23 °C
+		uint16_t antennaDelay16; // antenna delay for 16 MHz PRF
+		uint16_t antennaDelay64; // antenna delay for 64 MHz PRF
+		byte     xtalTrim;
+	};
+	
+	static const OtpCalibration& getOtpCalibration() { return _otpCalibration; }
+	
 	// host-initiated reading of temperature and battery voltage
 	static void getTempAndVbat(float& temp, float& vbat);
 	
+	/* ##### Temperature and voltage compensation ################################ */
+	/** 
+	One row of a temperature compensation table: offsets to the tuned values at `temperature` [°C],
+	in steps of 0.5 dB TX power (fine gain), of the PG delay and of the antenna delay [time units].
+	The offsets are interpolated between rows, which have to be sorted by temperature. Tables are
+	expected in flash (PROGMEM). The default tables are neutral (all offsets 0), so the compensation
+	only changes anything with tables measured on your hardware, relative to 23 °C (the OTP reference
+	of the temperature sensor), see `setCompensationTables()`.
+	*/
+	struct TempCompensation {
+		int8_t temperature;
+		int8_t txPower;
+		int8_t pgDelay;
+		int8_t antennaDelay;
+	};
+	
+	/** 
+	One row of a battery voltage compensation table: TX power offset (0.5 dB steps) at `vbat` [0.1 V].
+	*/
+	struct VbatCompensation {
+		byte   vbat;
+		int8_t txPower;
+	};
+	
+	struct CompensationStatistics {
+		float    temperature;    // last sample [°C]
+		float    vbat;           // last sample [V]
+		float    minTemperature;
+		float    maxTemperature;
+		float    minVbat;
+		float    maxVbat;
+		float    temperatureRate; // smoothed drift [°C/min]
+		uint32_t samples;
+		uint16_t adjustments;     // how often the offsets below changed
+		int8_t   txPowerOffset;   // applied offsets, see TempCompensation
+		int8_t   pgDelayOffset;
+		int8_t   antennaDelayOffset;
+	};
+	
+	/** 
+	Samples temperature and battery voltage periodically and adjusts TX power, PG delay and antenna
+	delay against drift. Needs `updateCompensation()` to be called regularly, e.g. from `loop()`.
+
+	@param[in] val `true` to enable the compensation, `false` restores the tuned values.
+	@param[in] intervalMs Time between two samples [ms].
+	*/
+	static void useTempAndVbatCompensation(boolean val, uint16_t intervalMs = 1000);
+	
+	/** 
+	Replaces the compensation tables (both in flash), pass `nullptr` to use the neutral default one.
+	*/
+	static void setCompensationTables(const TempCompensation* temp, byte tempRows, const VbatCompensation* vbat, byte vbatRows);
+	
+	/** 
+	Non-blocking step of the compensation: starts a SAR conversion when a sample is due and reads
+	it back at the next call, so no call waits for the converter.
+
+	@return `true` if a new sample has been taken.
+	*/
+	static boolean updateCompensation();
+	
+	static const CompensationStatistics& getCompensationStatistics() { return _compensationStatistics; }
+	
 	// transmission/reception bit rate
 	static constexpr byte TRX_RATE_110KBPS  = 0x00;
 	static constexpr byte TRX_RATE_850KBPS  = 0x01;
@@ -403,6 +882,15 @@ public:
 	static constexpr byte PREAMBLE_CODE_64MHZ_19 = 19;
 	static constexpr byte PREAMBLE_CODE_64MHZ_20 = 20;
 	
+	/* frame filter presets. */
+	static constexpr byte FRAME_FILTER_NONE   = 0x00;
+	static constexpr byte FRAME_FILTER_TAG    = 0x01;
+	static constexpr byte FRAME_FILTER_ANCHOR = 0x02;
+	
+	/* configuration snapshot header, the version changes with the layout. */
+	static constexpr uint16_t CONFIG_SNAPSHOT_MAGIC   = 0xDC0F;
+	static constexpr uint16_t CONFIG_SNAPSHOT_VERSION = 2;
+	
 	/* frame length settings. */
 	static constexpr byte FRAME_LENGTH_NORMAL   = 0x00;
 	static constexpr byte FRAME_LENGTH_EXTENDED = 0x03;
@@ -415,6 +903,14 @@ public:
 	static constexpr byte MODE_SHORTDATA_FAST_ACCURACY[] = {TRX_RATE_6800KBPS, TX_PULSE_FREQ_64MHZ, TX_PREAMBLE_LEN_128};
 	static constexpr byte MODE_LONGDATA_FAST_ACCURACY[]  = {TRX_RATE_6800KBPS, TX_PULSE_FREQ_64MHZ, TX_PREAMBLE_LEN_1024};
 	static constexpr byte MODE_LONGDATA_RANGE_ACCURACY[] = {TRX_RATE_110KBPS, TX_PULSE_FREQ_64MHZ, TX_PREAMBLE_LEN_2048};
+	
+	/* pre-defined radio configuration profiles (see enableMode(const DW1000Profile&)). */
+	static constexpr DW1000Profile PROFILE_LONGDATA_RANGE_LOWPOWER  = DW1000Profile(CHANNEL_5, TX_PULSE_FREQ_16MHZ, PREAMBLE_CODE_16MHZ_4, TX_PREAMBLE_LEN_2048, PAC_SIZE_64, DW1000Profile::SFD_DECAWAVE, TRX_RATE_110KBPS);
+	static constexpr DW1000Profile PROFILE_SHORTDATA_FAST_LOWPOWER  = DW1000Profile(CHANNEL_5, TX_PULSE_FREQ_16MHZ, PREAMBLE_CODE_16MHZ_4, TX_PREAMBLE_LEN_128, PAC_SIZE_8, DW1000Profile::SFD_STANDARD, TRX_RATE_6800KBPS);
+	static constexpr DW1000Profile PROFILE_LONGDATA_FAST_LOWPOWER   = DW1000Profile(CHANNEL_5, TX_PULSE_FREQ_16MHZ, PREAMBLE_CODE_16MHZ_4, TX_PREAMBLE_LEN_1024, PAC_SIZE_32, DW1000Profile::SFD_STANDARD, TRX_RATE_6800KBPS);
+	static constexpr DW1000Profile PROFILE_SHORTDATA_FAST_ACCURACY  = DW1000Profile(CHANNEL_5, TX_PULSE_FREQ_64MHZ, PREAMBLE_CODE_64MHZ_10, TX_PREAMBLE_LEN_128, PAC_SIZE_8, DW1000Profile::SFD_STANDARD, TRX_RATE_6800KBPS);
+	static constexpr DW1000Profile PROFILE_LONGDATA_FAST_ACCURACY   = DW1000Profile(CHANNEL_5, TX_PULSE_FREQ_64MHZ, PREAMBLE_CODE_64MHZ_10, TX_PREAMBLE_LEN_1024, PAC_SIZE_32, DW1000Profile::SFD_STANDARD, TRX_RATE_6800KBPS);
+	static constexpr DW1000Profile PROFILE_LONGDATA_RANGE_ACCURACY  = DW1000Profile(CHANNEL_5, TX_PULSE_FREQ_64MHZ, PREAMBLE_CODE_64MHZ_10, TX_PREAMBLE_LEN_2048, PAC_SIZE_64, DW1000Profile::SFD_DECAWAVE, TRX_RATE_110KBPS);
 
 //private:
 	/* chip select, reset and interrupt pins. */
@@ -438,9 +934,33 @@ public:
 	static byte _sysmask[LEN_SYS_MASK];
 	static byte _chanctrl[LEN_CHAN_CTRL];
 	
-	/* device status monitoring */
-	static byte _vmeas3v3;
-	static byte _tmeas23C;
+	/* calibration values from OTP. */
+	static OtpCalibration _otpCalibration;
+	static byte           _crystalTrim;
+	static void loadOtpCalibration();
+
+	/* temperature and voltage compensation. */
+	static boolean                 _compensationEnabled;
+	static boolean                 _compensationDirty;
+	static boolean                 _sarConverting;
+	static uint16_t                _compensationInterval;
+	static uint32_t                _compensationTime;
+	static uint32_t                _compensationSampleTime; // of the last sample
+	static uint32_t                _sarStartTime;
+	static const TempCompensation* _tempCompensation;
+	static byte                    _tempCompensationRows;
+	static const VbatCompensation* _vbatCompensation;
+	static byte                    _vbatCompensationRows;
+	static byte                    _txPowerTuned[LEN_TX_POWER];
+	static byte                    _pgDelayTuned;
+	static CompensationStatistics  _compensationStatistics;
+	static void startSarConversion();
+	static void readSarConversion(float& temp, float& vbat);
+	static void noteCompensationSample(float temp, float vbat);
+	static void applyCompensation(boolean force);
+	// antenna delay as written to the chip, see writeAntennaDelay()
+	static uint16_t getCompensatedAntennaDelay();
+	static void writeAntennaDelay();
 
 	/* PAN and short address. */
 	static byte _networkAndAddress[LEN_PANADR];
@@ -460,28 +980,27 @@ public:
 	/* internal helper to remember how to properly act. */
 	static boolean _permanentReceive;
 	static boolean _frameCheck;
+
+	/* low duty-cycle receive (SNIFF) settings and whether they are active on the chip. */
+	static byte    _sniffOnTime;
+	static byte    _sniffOffTime;
+	static boolean _sniffActive;
 	
 	// whether RX or TX is active
 	static uint8_t _deviceMode;
 
 	// whether debounce clock is active
 	static boolean _debounceClockEnabled;
+	
+	// duration of the last wake-up
+	static uint32_t _wakeLatency;
+	
+	/* deep sleep state reconciliation. */
+	static void restoreConfiguration();
 
 	/* Arduino interrupt handler */
 	static void handleInterrupt();
 	
-	/* Allow MAC frame filtering . */
-	// TODO auto-acknowledge
-	static void setFrameFilter(boolean val);
-	static void setFrameFilterBehaveCoordinator(boolean val);
-	static void setFrameFilterAllowBeacon(boolean val);
-	//data type is used in the FC_1 0x41
-	static void setFrameFilterAllowData(boolean val);
-	static void setFrameFilterAllowAcknowledgement(boolean val);
-	static void setFrameFilterAllowMAC(boolean val);
-	//Reserved is used for the Blink message
-	static void setFrameFilterAllowReserved(boolean val);
-	
 	// note: not sure if going to be implemented for now
 	static void setDoubleBuffering(boolean val);
 	// TODO is implemented, but needs testing
@@ -522,21 +1041,41 @@ public:
 	
 	/* clock management. */
 	static void enableClock(byte clock);
+	static boolean waitForClockLock(uint16_t timeoutUs);
+	
+	/* start up timing. */
+	static BootProfile _bootProfile;
+	static uint16_t bootPhase(uint32_t& since);
+	
+	/* polling of status bits, instead of fixed delays. */
+	static boolean waitForBits(byte cmd, uint16_t offset, uint32_t mask, uint32_t value, uint16_t timeoutUs);
+
+	/* SNIFF mode register management. */
+	static void writeSniffMode(boolean enable);
+	
+	/* test mode management. */
+	static void disablePacketSequencing();
+	static void forceTransmitClocks();
+	
+	/* accumulator memory access. */
+	static void enableAccumulatorClock(boolean val);
+	static void readAccumulatorBytes(uint16_t firstTap, byte data[], uint16_t numTaps);
 	
 	/* LDE micro-code management. */
 	static void manageLDE();
 	
 	/* timestamp correction. */
-	static void correctTimestamp(DW1000Time& timestamp);
+	static void correctTimestamp(DW1000Time& timestamp, float rxPower);
 	
 	/* reading and writing bytes from and to DW1000 module. */
 	static void readBytes(byte cmd, uint16_t offset, byte data[], uint16_t n);
-	static void readBytesOTP(uint16_t address, byte data[]);
+	static void readBytesOTP(uint16_t address, byte data[], uint8_t words = 1);
 	static void writeByte(byte cmd, uint16_t offset, byte data);
 	static void writeBytes(byte cmd, uint16_t offset, byte data[], uint16_t n);
 	
-	/* writing numeric values to bytes. */
+	/* writing numeric values to bytes and reading them back (little endian, n <= 4). */
 	static void writeValueToBytes(byte data[], int32_t val, uint16_t n);
+	static uint32_t bytesAsValue(const byte data[], uint16_t n);
 	
 	/* internal helper for bit operations on multi-bytes. */
 	static boolean getBit(byte data[], uint16_t n, uint16_t bit);
@@ -0,0 +1,185 @@
+/*
+ * Decawave DW1000 library for arduino.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file DW1000AntennaCalibration.cpp
+ * Antenna delay calibration of a group of nodes at known distances.
+ */
+
+#include <stddef.h>
+#include "DW1000AntennaCalibration.h"
+#include "DW1000.h"
+#include "DW1000Time.h"
+
+constexpr uint16_t DW1000AntennaCalibration::RECORD_MAGIC;
+constexpr uint16_t DW1000AntennaCalibration::RECORD_VERSION;
+
+DW1000AntennaCalibration::DW1000AntennaCalibration(uint8_t nodeCount, uint16_t baseDelay) {
+	_nodeCount = nodeCount < ANTENNA_CALIBRATION_MAX_NODES ? nodeCount : ANTENNA_CALIBRATION_MAX_NODES;
+	_baseDelay = baseDelay;
+	clear();
+}
+
+void DW1000AntennaCalibration::clear() {
+	memset(_errorSum, 0, sizeof(_errorSum));
+	memset(_errorSquareSum, 0, sizeof(_errorSquareSum));
+	memset(_count, 0, sizeof(_count));
+}
+
+int8_t DW1000AntennaCalibration::pairIndex(uint8_t nodeA, uint8_t nodeB) {
+	if(nodeA == nodeB || nodeA >= _nodeCount || nodeB >= _nodeCount) {
+		return -1;
+	}
+	if(nodeA > nodeB) {
+		uint8_t swap = nodeA;
+		nodeA = nodeB;
+		nodeB = swap;
+	}
+	// row-wise upper triangle without diagonal
+	return nodeA*(2*ANTENNA_CALIBRATION_MAX_NODES-nodeA-1)/2+(nodeB-nodeA-1);
+}
+
+boolean DW1000AntennaCalibration::addMeasurement(uint8_t nodeA, uint8_t nodeB, float measuredDistance, float trueDistance) {
+	int8_t pair = pairIndex(nodeA, nodeB);
+	if(pair < 0 || _count[pair] == 0xFFFF) {
+		return false;
+	}
+	float error = measuredDistance-trueDistance;
+	_errorSum[pair]       += error;
+	_errorSquareSum[pair] += error*error;
+	_count[pair]++;
+	return true;
+}
+
+uint16_t DW1000AntennaCalibration::getMeasurementCount(uint8_t nodeA, uint8_t nodeB) {
+	int8_t pair = pairIndex(nodeA, nodeB);
+	return pair < 0 ? 0 : _count[pair];
+}
+
+uint32_t DW1000AntennaCalibration::getMeasurementCount() {
+	uint32_t total = 0;
+	for(uint8_t i = 0; i < ANTENNA_CALIBRATION_MAX_PAIRS; i++) {
+		total += _count[i];
+	}
+	return total;
+}
+
+boolean DW1000AntennaCalibration::solve(AntennaCalibrationRecord& record) {
+	const uint8_t n = _nodeCount;
+	if(n < 3) {
+		return false;
+	}
+	// normal equations (A^T A) e = A^T b, every measurement is a row of A with a 1 for both nodes
+	float m[ANTENNA_CALIBRATION_MAX_NODES][ANTENNA_CALIBRATION_MAX_NODES+1];
+	memset(m, 0, sizeof(m));
+	for(uint8_t i = 0; i < n; i++) {
+		for(uint8_t j = i+1; j < n; j++) {
+			int8_t pair = pairIndex(i, j);
+			m[i][i] += _count[pair];
+			m[j][j] += _count[pair];
+			m[i][j] += _count[pair];
+			m[j][i] += _count[pair];
+			m[i][n] += _errorSum[pair];
+			m[j][n] += _errorSum[pair];
+		}
+	}
+	float scale = 0;
+	for(uint8_t i = 0; i < n; i++) {
+		if(m[i][i] > scale) {
+			scale = m[i][i];
+		}
+	}
+	// gauss-jordan elimination with partial pivoting, a (nearly) zero pivot means the pairs do not determine all delays
+	for(uint8_t col = 0; col < n; col++) {
+		uint8_t pivot = col;
+		for(uint8_t row = col+1; row < n; row++) {
+			if(fabs(m[row][col]) > fabs(m[pivot][col])) {
+				pivot = row;
+			}
+		}
+		if(fabs(m[pivot][col]) < 1e-3f*scale) {
+			return false;
+		}
+		if(pivot != col) {
+			for(uint8_t k = col; k <= n; k++) {
+				float swap = m[col][k];
+				m[col][k] = m[pivot][k];
+				m[pivot][k] = swap;
+			}
+		}
+		for(uint8_t row = 0; row < n; row++) {
+			if(row == col || m[row][col] == 0) {
+				continue;
+			}
+			float factor = m[row][col]/m[col][col];
+			for(uint8_t k = col; k <= n; k++) {
+				m[row][k] -= factor*m[col][k];
+			}
+		}
+	}
+	float error[ANTENNA_CALIBRATION_MAX_NODES];
+	for(uint8_t i = 0; i < n; i++) {
+		error[i] = m[i][n]/m[i][i];
+	}
+	// residual: sum over all measurements of (e - e_i - e_j)^2, from the per pair sums
+	float    squares = 0;
+	uint32_t total   = 0;
+	for(uint8_t i = 0; i < n; i++) {
+		for(uint8_t j = i+1; j < n; j++) {
+			int8_t pair = pairIndex(i, j);
+			float  fit  = error[i]+error[j];
+			squares += _errorSquareSum[pair]-2*fit*_errorSum[pair]+_count[pair]*fit*fit;
+			total   += _count[pair];
+		}
+	}
+
+	memset(&record, 0, sizeof(AntennaCalibrationRecord));
+	record.nodeCount = n;
+	for(uint8_t i = 0; i < n; i++) {
+		// the delay is subtracted from both timestamps of a node, i.e. one unit of delay is one unit of time of flight
+		int32_t delay = _baseDelay+(int32_t)round(error[i]*DW1000Time::DISTANCE_OF_RADIO_INV);
+		record.antennaDelay[i] = delay < 0 ? 0 : delay > 0xFFFF ? 0xFFFF : (uint16_t)delay;
+	}
+	record.residualError = squares > 0 ? sqrt(squares/total) : 0;
+	record.measurements  = total;
+	record.magic         = RECORD_MAGIC;
+	record.version       = RECORD_VERSION;
+	record.size          = sizeof(AntennaCalibrationRecord);
+	record.crc           = recordCrc(record);
+	return true;
+}
+
+uint16_t DW1000AntennaCalibration::recordCrc(const AntennaCalibrationRecord& record) {
+	const byte* data = (const byte*)&record;
+	return DW1000Class::crc16(data+offsetof(AntennaCalibrationRecord, nodeCount),
+	                          sizeof(AntennaCalibrationRecord)-offsetof(AntennaCalibrationRecord, nodeCount));
+}
+
+boolean DW1000AntennaCalibration::isValidRecord(const AntennaCalibrationRecord& record) {
+	if(record.magic != RECORD_MAGIC || record.version != RECORD_VERSION) {
+		return false;
+	}
+	if(record.size != sizeof(AntennaCalibrationRecord) || record.nodeCount > ANTENNA_CALIBRATION_MAX_NODES) {
+		return false;
+	}
+	return record.crc == recordCrc(record);
+}
+
+boolean DW1000AntennaCalibration::apply(const AntennaCalibrationRecord& record, uint8_t node) {
+	if(!isValidRecord(record) || node >= record.nodeCount) {
+		return false;
+	}
+	DW1000.setAntennaDelay(record.antennaDelay[node]);
+	return true;
+}
@@ -0,0 +1,110 @@
+/*
+ * Decawave DW1000 library for arduino.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file DW1000AntennaCalibration.h
+ * Antenna delay calibration of a group of nodes at known distances.
+ *
+ * @note
+ * Every ranging result between two nodes i and j is off by the (uncompensated)
+ * antenna delays of both nodes: measured - true = e_i + e_j. With three or more
+ * nodes and enough different pairs the delays are the least squares solution of
+ * these equations. All nodes have to range with the same (base) antenna delay
+ * while measurements are collected, the solution is relative to it.
+ */
+
+#ifndef _DW1000AntennaCalibration_H_INCLUDED
+#define _DW1000AntennaCalibration_H_INCLUDED
+
+#include <Arduino.h>
+#include "require_cpp11.h"
+
+#define ANTENNA_CALIBRATION_MAX_NODES 6
+#define ANTENNA_CALIBRATION_MAX_PAIRS (ANTENNA_CALIBRATION_MAX_NODES*(ANTENNA_CALIBRATION_MAX_NODES-1)/2)
+
+/**
+Result of a calibration, meant to be persisted (e.g. in EEPROM) and applied at every start.
+The header (magic, layout version, size and CRC-16 over the rest) rejects stale or corrupted records.
+*/
+struct AntennaCalibrationRecord {
+	uint16_t magic;
+	uint16_t version;
+	uint16_t size;
+	uint16_t crc;
+	uint8_t  nodeCount;
+	uint16_t antennaDelay[ANTENNA_CALIBRATION_MAX_NODES]; // [time units] per node
+	float    residualError;                               // [m] RMS of the remaining range errors
+	uint32_t measurements;
+};
+
+class DW1000AntennaCalibration {
+public:
+	static constexpr uint16_t RECORD_MAGIC   = 0xDCA1;
+	static constexpr uint16_t RECORD_VERSION = 1;
+
+	/**
+	@param[in] nodeCount Number of nodes taking part (3 to ANTENNA_CALIBRATION_MAX_NODES).
+	@param[in] baseDelay Antenna delay all nodes range with while measurements are collected.
+	*/
+	DW1000AntennaCalibration(uint8_t nodeCount, uint16_t baseDelay = 16384);
+
+	// forget all measurements
+	void clear();
+
+	/**
+	Adds one ranging result between two nodes.
+
+	@param[in] nodeA, nodeB Indices of the nodes (0 to nodeCount-1).
+	@param[in] measuredDistance Range as reported by ranging (without range bias correction) [m].
+	@param[in] trueDistance Known distance of both antennas [m].
+	@return `false` if the indices are invalid.
+	*/
+	boolean addMeasurement(uint8_t nodeA, uint8_t nodeB, float measuredDistance, float trueDistance);
+
+	uint16_t getMeasurementCount(uint8_t nodeA, uint8_t nodeB);
+	uint32_t getMeasurementCount();
+	uint8_t getNodeCount() { return _nodeCount; }
+
+	/**
+	Solves for the antenna delays of all nodes.
+
+	@param[out] record The antenna delays with their residual error, with a valid header.
+	@return `false` (and the record untouched) if the measured pairs do not determine all delays,
+	e.g. if a node has no measurements or all pairs share one node.
+	*/
+	boolean solve(AntennaCalibrationRecord& record);
+
+	static boolean isValidRecord(const AntennaCalibrationRecord& record);
+
+	/**
+	Sets the antenna delay of one node from a record, call it before the configuration
+	is committed (e.g. before `DW1000Ranging.startAsTag()`).
+
+	@return `false` if the record is invalid or has no entry for the node.
+	*/
+	static boolean apply(const AntennaCalibrationRecord& record, uint8_t node);
+
+private:
+	uint8_t  _nodeCount;
+	uint16_t _baseDelay;
+	// error sums [m] and counts per pair, i.e. the normal equations without storing all measurements
+	float    _errorSum[ANTENNA_CALIBRATION_MAX_PAIRS];
+	float    _errorSquareSum[ANTENNA_CALIBRATION_MAX_PAIRS];
+	uint16_t _count[ANTENNA_CALIBRATION_MAX_PAIRS];
+
+	int8_t pairIndex(uint8_t nodeA, uint8_t nodeB);
+	static uint16_t recordCrc(const AntennaCalibrationRecord& record);
+};
+
+#endif
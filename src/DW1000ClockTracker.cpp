@@ -0,0 +1,102 @@
+/*
+ * Decawave DW1000 library for arduino.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file DW1000ClockTracker.cpp
+ * Online model of the clock of a peer relative to ours.
+ */
+
+#include "DW1000ClockTracker.h"
+
+constexpr float   DW1000ClockTracker::MEASUREMENT_NOISE;
+constexpr float   DW1000ClockTracker::SKEW_NOISE;
+constexpr float   DW1000ClockTracker::INITIAL_SKEW_DEVIATION;
+constexpr float   DW1000ClockTracker::OUTLIER_SIGMAS;
+constexpr uint8_t DW1000ClockTracker::OUTLIER_RESTART;
+
+void DW1000ClockTracker::reset(float skew) {
+	_localRef            = DW1000Timestamp();
+	_peerRef             = DW1000Timestamp();
+	_phase               = 0;
+	_skew                = skew;
+	_p00                 = MEASUREMENT_NOISE*MEASUREMENT_NOISE;
+	_p01                 = 0;
+	_p11                 = INITIAL_SKEW_DEVIATION*INITIAL_SKEW_DEVIATION;
+	_jitter              = 0;
+	_samples             = 0;
+	_outliers            = 0;
+	_consecutiveOutliers = 0;
+}
+
+boolean DW1000ClockTracker::update(const DW1000Timestamp& local, const DW1000Timestamp& peer) {
+	if(_samples == 0) {
+		_localRef = local;
+		_peerRef  = peer;
+		_samples  = 1;
+		return true;
+	}
+	int64_t dt = local.since(_localRef);
+	if(dt <= 0) {
+		return false;
+	}
+	// observed offset change, small (skew * dt) for every dt within the timer wrap
+	float z = (float)(peer.since(_peerRef)-dt);
+	float a = dt*1e-6f; // skew [ppm] to offset change
+	// predict: the offset moves with the skew, the skew is a random walk
+	float q   = SKEW_NOISE*SKEW_NOISE*dt/(float)DW1000Time::TICKS_PER_SECOND;
+	float p00 = _p00+2*a*_p01+a*a*_p11+q*a*a/3;
+	float p01 = _p01+a*_p11+q*a/2;
+	float p11 = _p11+q;
+	float predicted = _phase+_skew*a;
+	float residual  = z-predicted;
+	float variance  = p00+MEASUREMENT_NOISE*MEASUREMENT_NOISE;
+	if(residual*residual > OUTLIER_SIGMAS*OUTLIER_SIGMAS*variance) {
+		_outliers++;
+		if(++_consecutiveOutliers >= OUTLIER_RESTART) {
+			// keep the skew, the oscillator of the peer is still the same
+			uint16_t outliers = _outliers;
+			reset(_skew);
+			_outliers = outliers;
+		}
+		return false;
+	}
+	_consecutiveOutliers = 0;
+	// correct
+	float k0 = p00/variance;
+	float k1 = p01/variance;
+	_phase = predicted+k0*residual;
+	_skew += k1*residual;
+	_p00   = (1-k0)*p00;
+	_p01   = (1-k0)*p01;
+	_p11   = p11-k1*p01;
+	// move the reference to this observation, the offset stays small
+	_localRef = local;
+	_peerRef  = peer;
+	_phase   -= z;
+	_jitter   = _samples == 1 ? residual*residual : _jitter+(residual*residual-_jitter)/16;
+	if(_samples < 0xFFFF) {
+		_samples++;
+	}
+	return true;
+}
+
+DW1000Timestamp DW1000ClockTracker::toPeerTime(const DW1000Timestamp& local) const {
+	int64_t dt = local.since(_localRef);
+	return DW1000Timestamp(_peerRef)+DW1000Time(dt+(int64_t)round(_phase+_skew*dt*1e-6f));
+}
+
+DW1000Time DW1000ClockTracker::toLocalDuration(const DW1000Time& peerDuration) const {
+	int64_t ticks = peerDuration.getTimestamp();
+	return DW1000Time(ticks-(int64_t)round(ticks*_skew*1e-6f));
+}
@@ -0,0 +1,95 @@
+/*
+ * Decawave DW1000 library for arduino.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file DW1000ClockTracker.h
+ * Online model of the clock of a peer relative to ours.
+ *
+ * @note
+ * Every frame with the send timestamp of the peer and our receive timestamp is
+ * an observation of peer time = our time + offset (+ time of flight, which is
+ * constant and ends up in the offset). A two state Kalman filter tracks the
+ * offset and its rate, the skew. The offset is kept relative to the last
+ * observation, so floats are precise enough for any timestamp.
+ */
+
+#ifndef _DW1000ClockTracker_H_INCLUDED
+#define _DW1000ClockTracker_H_INCLUDED
+
+#include <Arduino.h>
+#include "DW1000Time.h"
+#include "DW1000Timestamp.h"
+
+class DW1000ClockTracker {
+public:
+	// timestamp noise (1 sigma) [time units], about 0.3 ns
+	static constexpr float   MEASUREMENT_NOISE      = 20.0f;
+	// random walk of the skew, e.g. due to temperature [ppm/s^(1/2)]
+	static constexpr float   SKEW_NOISE             = 0.05f;
+	// uncertainty of an initial skew (1 sigma) [ppm]
+	static constexpr float   INITIAL_SKEW_DEVIATION = 20.0f;
+	// observations further off than this many standard deviations are rejected
+	static constexpr float   OUTLIER_SIGMAS         = 5.0f;
+	// so many consecutive outliers restart the model (e.g. the peer was reset)
+	static constexpr uint8_t OUTLIER_RESTART        = 3;
+
+	DW1000ClockTracker() { reset(); }
+
+	/**
+	Forgets the model. The next observation starts it again with the given skew, e.g. the
+	clock offset from the carrier integrator (DW1000Class::getClockOffset()).
+
+	@param[in] skew Initial skew [ppm], positive if the peer's clock runs faster.
+	*/
+	void reset(float skew = 0.0f);
+
+	/**
+	Adds one observation of the same event in both clocks.
+
+	@param[in] local Our timestamp, e.g. the receive timestamp of a frame.
+	@param[in] peer The peer's timestamp of the same event, e.g. its send timestamp.
+	@return `false` if rejected as outlier (or out of order).
+	*/
+	boolean update(const DW1000Timestamp& local, const DW1000Timestamp& peer);
+
+	// at least two observations, i.e. a skew was measured
+	boolean isValid() const { return _samples >= 2; }
+	uint16_t getSamples() const { return _samples; }
+	// [ppm], positive if the peer's clock runs faster
+	float getSkew() const { return _skew; }
+	// standard deviation of the skew estimate [ppm]
+	float getSkewDeviation() const { return sqrt(_p11); }
+	// smoothed RMS of the prediction errors [time units], the stability of the link/clocks
+	float getJitter() const { return sqrt(_jitter); }
+	uint16_t getOutliers() const { return _outliers; }
+
+	// peer time of an event at our time `local`
+	DW1000Timestamp toPeerTime(const DW1000Timestamp& local) const;
+	// a duration measured by the peer in our time units, e.g. its reply time for single-sided ranging
+	DW1000Time toLocalDuration(const DW1000Time& peerDuration) const;
+
+private:
+	DW1000PackedTimestamp _localRef;
+	DW1000PackedTimestamp _peerRef;
+	// offset of the estimate from _peerRef [time units], skew [ppm] and their covariance
+	float    _phase;
+	float    _skew;
+	float    _p00, _p01, _p11;
+	float    _jitter; // mean square prediction error [time units^2]
+	uint16_t _samples;
+	uint16_t _outliers;
+	uint8_t  _consecutiveOutliers;
+};
+
+#endif
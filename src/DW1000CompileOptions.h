@@ -30,4 +30,17 @@
  */
 #define DW1000TIME_H_PRINTABLE true
 
+/**
+ * Precision of the time of flight of double-sided two-way ranging (see DW1000Tof.h)
+ * DW1000TOF_EXACT: exact (rounded) result with 128 bit intermediates for any reply time up to half
+ *                  the timer wrap, costs a 42 step shift-subtract division on 8/32 bit MCUs
+ * DW1000TOF_FLOAT: single precision float, no 64 bit multiplication or division, at most 1 time
+ *                  unit (4.7 mm) off the exact result (extras/tools/tof_bench.cpp)
+ */
+#define DW1000TOF_EXACT 0
+#define DW1000TOF_FLOAT 1
+#ifndef DW1000TOF_PRECISION
+#define DW1000TOF_PRECISION DW1000TOF_EXACT
+#endif
+
 #endif // DW1000COMPILEOPTIONS_H
@@ -38,6 +38,8 @@
 // device id register
 #define DEV_ID 0x00
 #define LEN_DEV_ID 4
+#define RIDTAG_MASK 0xFFFF0000
+#define RIDTAG_DECAWAVE 0xDECA0000
 
 // extended unique identifier register
 #define EUI 0x01
@@ -97,6 +99,7 @@
 #define LDEERR_BIT 18
 #define RFPLL_LL_BIT 24
 #define CLKPLL_LL_BIT 25
+#define AFFREJ_BIT 29
 
 // system event mask register
 // NOTE: uses the bit definitions of SYS_STATUS (below 32)
@@ -111,8 +114,10 @@
 #define RX_TIME 0x15
 #define LEN_RX_TIME 14
 #define RX_STAMP_SUB 0x00
+#define FP_INDEX_SUB 0x05
 #define FP_AMPL1_SUB 0x07
 #define LEN_RX_STAMP LEN_STAMP
+#define LEN_FP_INDEX 2
 #define LEN_FP_AMPL1 2
 
 // RX frame quality
@@ -143,6 +148,13 @@
 #define LEN_UWB_FRAMES 127
 #define LEN_EXT_UWB_FRAMES 1023
 
+// accumulator (channel impulse response) memory, read only
+#define ACC_MEM 0x25
+#define LEN_ACC_MEM 4064
+#define LEN_ACC_SAMPLE 4
+#define ACC_LENGTH_16MHZ 992
+#define ACC_LENGTH_64MHZ 1016
+
 // RX frame info
 #define RX_FINFO 0x10
 #define LEN_RX_FINFO 4
@@ -176,6 +188,19 @@
 #define LEN_OTP_ADDR 2
 #define LEN_OTP_CTRL 2
 #define LEN_OTP_RDAT 4
+#define LDELOAD_BIT 15
+#define OTP_SF_SUB 0x12
+#define LDO_KICK_BIT 1
+
+// OTP memory map, calibration area (see user manual 6.3.1)
+#define OTP_LDOTUNE_ADDR 0x004
+#define LEN_OTP_LDOTUNE 5
+#define OTP_PARTID_ADDR 0x006
+#define OTP_LOTID_ADDR 0x007
+#define OTP_VBAT_ADDR 0x008
+#define OTP_VTEMP_ADDR 0x009
+#define OTP_ANTDELAY_ADDR 0x01C
+#define OTP_XTALT_ADDR 0x01E
 
 // AGC_TUNE1/2 (for re-tuning only)
 #define AGC_TUNE 0x23
@@ -193,11 +218,18 @@
 #define DRX_TUNE1b_SUB 0x06
 #define DRX_TUNE2_SUB 0x08
 #define DRX_TUNE4H_SUB 0x26
+#define DRX_CAR_INT_SUB 0x28
 #define LEN_DRX_TUNE0b 2
 #define LEN_DRX_TUNE1a 2
 #define LEN_DRX_TUNE1b 2
 #define LEN_DRX_TUNE2 4
 #define LEN_DRX_TUNE4H 2
+#define LEN_DRX_CAR_INT 3
+#define DRX_CAR_INT_SIGN_BIT 20
+// carrier integrator to frequency offset in Hz (user manual 7.2.40.11), 110 kb/s integrates longer
+#define FREQ_OFFSET_MULTIPLIER (998.4e6/2.0/1024.0/131072.0)
+#define FREQ_OFFSET_MULTIPLIER_110KB (998.4e6/2.0/8192.0/131072.0)
+#define LEN_DRX_TUNE_IMAGE (DRX_TUNE2_SUB+LEN_DRX_TUNE2-DRX_TUNE0b_SUB)
 
 // LDE_CFG1 (for re-tuning only)
 #define LDE_IF 0x2E
@@ -210,16 +242,27 @@
 #define LEN_LDE_REPC 2
 #define LEN_LDE_RXANTD 2
 
+// RX_SNIFF (low duty-cycle preamble hunting)
+#define RX_SNIFF 0x1D
+#define LEN_RX_SNIFF 4
+#define SNIFF_ONT_MASK 0x0F
+
 // TX_POWER (for re-tuning only)
 #define TX_POWER 0x1E
 #define LEN_TX_POWER 4
+#define TX_POWER_FINE_MASK 0x1F
+#define TX_POWER_FINE_MAX 0x1F
 
 // RF_CONF (for re-tuning only)
 #define RF_CONF 0x28
+#define LEN_RF_CONF 4
+#define RF_CONF_TXPLLPOWEN 0x001FE000L
+#define RF_CONF_TXALLEN 0x005FE000L
 #define RF_RXCTRLH_SUB 0x0B
 #define RF_TXCTRL_SUB 0x0C
 #define LEN_RF_RXCTRLH 1
 #define LEN_RF_TXCTRL 4
+#define LEN_RF_CONF_IMAGE (RF_TXCTRL_SUB+LEN_RF_TXCTRL-RF_RXCTRLH_SUB)
 
 // TX_CAL (for re-tuning only)
 #define TX_CAL 0x2A
@@ -227,6 +270,11 @@
 #define LEN_TC_PGDELAY 1
 #define TC_SARC 0x00
 #define TC_SARL 0x03
+#define LEN_TC_SARL 2
+#define TC_SAR_CONVERSION_US 20
+#define TC_PGTEST_SUB 0x0C
+#define LEN_TC_PGTEST 1
+#define TC_PGTEST_CW 0x13
 
 // FS_CTRL (for re-tuning only)
 #define FS_CTRL 0x2B
@@ -236,12 +284,16 @@
 #define LEN_FS_PLLCFG 4
 #define LEN_FS_PLLTUNE 1
 #define LEN_FS_XTALT 1
+#define FS_XTALT_MAX 0x1F
+#define LEN_FS_PLL_IMAGE (FS_PLLTUNE_SUB+LEN_FS_PLLTUNE-FS_PLLCFG_SUB)
 
 // AON
 #define AON 0x2C
 #define AON_WCFG_SUB 0x00
 #define LEN_AON_WCFG 2
 #define ONW_LDC_BIT 6
+#define ONW_L64P_BIT 7
+#define ONW_LLDE_BIT 11
 #define ONW_LDD0_BIT 12
 #define AON_CTRL_SUB 0x02
 #define LEN_AON_CTRL 1
@@ -260,16 +312,46 @@
 #define PMSC 0x36
 #define PMSC_CTRL0_SUB 0x00
 #define PMSC_CTRL1_SUB 0x04
+#define PMSC_TXFSEQ_SUB 0x26
 #define PMSC_LEDC_SUB 0x28
 #define LEN_PMSC_CTRL0 4
 #define LEN_PMSC_CTRL1 4
+#define LEN_PMSC_TXFSEQ 2
 #define LEN_PMSC_LEDC 4
 #define GPDCE_BIT 18
 #define KHZCLKEN_BIT 23
+#define PLL2_SEQ_EN_BIT 24
 #define BLNKEN 8
 
 #define ATXSLP_BIT 11
 #define ARXSLP_BIT 12
+#define PKTSEQ_MASK 0x07F8
+#define PKTSEQ_DEFAULT 0x0738
+#define TXFSEQ_DEFAULT 0x0B74
+
+// DIG_DIAG (digital diagnostics, event counters)
+#define DIG_DIAG 0x2F
+#define EVC_CTRL_SUB 0x00
+#define LEN_EVC_CTRL 4
+#define EVC_EN_BIT 0
+#define EVC_CLR_BIT 1
+#define EVC_PHE_SUB 0x04
+#define EVC_RSE_SUB 0x06
+#define EVC_FCG_SUB 0x08
+#define EVC_FCE_SUB 0x0A
+#define EVC_FFR_SUB 0x0C
+#define EVC_OVR_SUB 0x0E
+#define EVC_STO_SUB 0x10
+#define EVC_PTO_SUB 0x12
+#define EVC_FWTO_SUB 0x14
+#define EVC_TXFS_SUB 0x16
+#define EVC_HPW_SUB 0x18
+#define EVC_TPW_SUB 0x1A
+#define LEN_EVC 2
+#define EVC_MASK 0x0FFF
+#define DIAG_TMC_SUB 0x24
+#define LEN_DIAG_TMC 2
+#define TX_PSTM_BIT 4
 
 // TX_ANTD Antenna delays
 #define TX_ANTD 0x18
@@ -293,4 +375,15 @@
 #define GPIO_MODE 0
 #define LED_MODE 1
 
+// other register files (only read for register snapshots)
+#define RX_FWTO 0x0C
+#define RX_TTCKI 0x13
+#define RX_TTCKO 0x14
+#define SYS_STATE 0x19
+#define ACK_RESP_T 0x1A
+#define EXT_SYNC 0x24
+#define LDE_THRESH_SUB 0x0000
+#define LDE_PPINDX_SUB 0x1000
+#define REGISTER_SNAPSHOT_MAX_BLOCK 58
+
 #endif
@@ -28,6 +28,7 @@
 //Constructor and destructor
 DW1000Device::DW1000Device() {
 	randomShortAddress();
+	initState();
 }
 
 DW1000Device::DW1000Device(byte deviceAddress[], boolean shortOne) {
@@ -40,6 +41,7 @@ DW1000Device::DW1000Device(byte deviceAddress[], boolean shortOne) {
 		//we have a short address (2 bytes)
 		setShortAddress(deviceAddress);
 	}
+	initState();
 }
 
 DW1000Device::DW1000Device(byte deviceAddress[], byte shortAddress[]) {
@@ -47,6 +49,7 @@ DW1000Device::DW1000Device(byte deviceAddress[], byte shortAddress[]) {
 	setAddress(deviceAddress);
 	//we set the 2 bytes address
 	setShortAddress(shortAddress);
+	initState();
 }
 
 DW1000Device::~DW1000Device() {
@@ -74,6 +77,8 @@ void DW1000Device::setFPPower(float FPPower) { _FPPower = round(FPPower*100); }
 
 void DW1000Device::setQuality(float quality) { _quality = round(quality*100); }
 
+void DW1000Device::setClockOffset(float offset) { _clockOffset = round(offset*100); }
+
 
 byte* DW1000Device::getByteAddress() {
 	return _ownAddress;
@@ -122,6 +127,35 @@ float DW1000Device::getFPPower() { return float(_FPPower)/100.0f; }
 
 float DW1000Device::getQuality() { return float(_quality)/100.0f; }
 
+float DW1000Device::getClockOffset() { return float(_clockOffset)/100.0f; }
+
+float DW1000Device::getRangeRate() { return float(_rangeRate)/100.0f; }
+
+void DW1000Device::noteRange() {
+	_rangeCount++;
+	updateRangeRate(millis());
+}
+
+void DW1000Device::updateRangeRate(uint16_t now) {
+	uint16_t elapsed = now-_rangeRateStart;
+	if(elapsed >= RANGE_RATE_WINDOW) {
+		_rangeRate      = (uint32_t)_rangeCount*100000UL/elapsed;
+		_rangeCount     = 0;
+		_rangeRateStart = now;
+	}
+}
+
+
+void DW1000Device::initState() {
+	_clockOffset      = 0;
+	_replyDelayTimeUS = 0;
+	_rangeRate        = 0;
+	_rangeCount       = 0;
+	_rangeRateStart   = millis();
+	_activity         = millis();
+	_expectedMessage  = 0; // POLL
+	_protocolFailed   = false;
+}
 
 void DW1000Device::randomShortAddress() {
 	_shortAddress[0] = random(0, 256);
@@ -129,13 +163,23 @@ void DW1000Device::randomShortAddress() {
 }
 
 void DW1000Device::noteActivity() {
-	_activity = millis();
+	uint16_t now = millis();
+	if((uint16_t)(now-_activity) > INACTIVITY_TIME) {
+		// back after a pause, the 16 bit window start may have wrapped meanwhile
+		_rangeRate      = 0;
+		_rangeCount     = 0;
+		_rangeRateStart = now;
+	} else {
+		// also close windows without ranges, so the elapsed time of a window never wraps
+		updateRangeRate(now);
+	}
+	_activity = now;
 }
 
 
 boolean DW1000Device::isInactive() {
 	//One second of inactivity
-	if(millis()-_activity > INACTIVITY_TIME) {
+	if((uint16_t)((uint16_t)millis()-_activity) > INACTIVITY_TIME) {
 		_activity = millis();
 		return true;
 	}
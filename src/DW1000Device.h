@@ -23,11 +23,15 @@
 
 
 #define INACTIVITY_TIME 1000
+//ranging rate is measured over at least this many ms
+#define RANGE_RATE_WINDOW 2000
 
 #ifndef _DW1000Device_H_INCLUDED
 #define _DW1000Device_H_INCLUDED
 
 #include "DW1000Time.h"
+#include "DW1000Timestamp.h"
+#include "DW1000ClockTracker.h"
 #include "DW1000Mac.h"
 
 class DW1000Mac;
@@ -52,17 +56,19 @@ public:
 	void setRXPower(float power);
 	void setFPPower(float power);
 	void setQuality(float quality);
+	void setClockOffset(float offset);
 	
 	void setReplyDelayTime(uint16_t time) { _replyDelayTimeUS = time; }
 	
-	void setIndex(int8_t index) { _index = index; }
+	void setIndex(int16_t index) { _index = index; }
 	
 	//getters
 	uint16_t getReplyTime() { return _replyDelayTimeUS; }
 	
 	byte* getByteAddress();
 	
-	int8_t getIndex() { return _index; }
+	// handle of the device in the device table, see DW1000DeviceTable
+	int16_t getIndex() { return _index; }
 	
 	//String getAddress();
 	byte* getByteShortAddress();
@@ -73,18 +79,36 @@ public:
 	float getRXPower();
 	float getFPPower();
 	float getQuality();
+	// clock offset of the device relative to ours in ppm (smoothed, see DW1000Class::getClockOffset())
+	float getClockOffset();
+	// clock skew of the device relative to ours in ppm, tracked over successive exchanges
+	// (where both timestamps of a frame are known, i.e. on the anchor), 0 while unknown
+	float getClockSkew() { return _clockTracker.isValid() ? _clockTracker.getSkew() : 0.0f; }
+	// the full clock model, e.g. its uncertainty and jitter or for skew-compensated single-sided ranging
+	DW1000ClockTracker& getClockTracker() { return _clockTracker; }
+	
+	// ranges per second with this device, updated every RANGE_RATE_WINDOW ms
+	float getRangeRate();
+	void  noteRange();
+	
+	// protocol state of the exchange with this device: the message expected next from it
+	// and whether the running exchange failed (anchor side)
+	void    setExpectedMessage(byte messageType) { _expectedMessage = messageType; }
+	byte    getExpectedMessage() { return _expectedMessage; }
+	void    setProtocolFailed(boolean failed) { _protocolFailed = failed; }
+	boolean isProtocolFailed() { return _protocolFailed; }
 	
 	boolean isAddressEqual(DW1000Device* device);
 	boolean isShortAddressEqual(DW1000Device* device);
 	
 	//functions which contains the date: (easier to put as public)
-	// timestamps to remember
-	DW1000Time timePollSent;
-	DW1000Time timePollReceived;
-	DW1000Time timePollAckSent;
-	DW1000Time timePollAckReceived;
-	DW1000Time timeRangeSent;
-	DW1000Time timeRangeReceived;
+	// timestamps to remember, 40 bit points in time packed into 5 bytes (calculate as DW1000Timestamp)
+	DW1000PackedTimestamp timePollSent;
+	DW1000PackedTimestamp timePollReceived;
+	DW1000PackedTimestamp timePollAckSent;
+	DW1000PackedTimestamp timePollAckReceived;
+	DW1000PackedTimestamp timeRangeSent;
+	DW1000PackedTimestamp timeRangeReceived;
 	
 	void    noteActivity();
 	boolean isInactive();
@@ -94,16 +118,28 @@ private:
 	//device ID
 	byte         _ownAddress[8];
 	byte         _shortAddress[2];
-	int32_t      _activity;
+	uint16_t     _activity; // [ms], lower 16 bit of millis(), enough for INACTIVITY_TIME
 	uint16_t     _replyDelayTimeUS;
-	int8_t       _index; // not used
+	int16_t      _index;
 	
 	int16_t _range;
 	int16_t _RXPower;
 	int16_t _FPPower;
 	int16_t _quality;
+	int16_t _clockOffset;
+	
+	uint16_t _rangeRate; // [ranges per 100 s]
+	uint16_t _rangeCount;
+	uint16_t _rangeRateStart; // [ms], lower 16 bit of millis()
+	
+	byte    _expectedMessage;
+	boolean _protocolFailed;
+	
+	DW1000ClockTracker _clockTracker;
 	
 	void randomShortAddress();
+	void updateRangeRate(uint16_t now);
+	void initState();
 	
 };
 
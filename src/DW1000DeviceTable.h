@@ -0,0 +1,212 @@
+/*
+ * Decawave DW1000 library for arduino.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file DW1000DeviceTable.h
+ * Table of the known devices with constant time lookup.
+ *
+ * @note
+ * Devices are stored densely (positions 0 to size()-1, e.g. for the order in a
+ * POLL frame), removing one moves the last device into its position. Every
+ * device also gets a handle (DW1000Device::getIndex()) which stays the same
+ * while it is in the table, no matter what else is removed. Lookup by short
+ * address and by EUI uses two open addressing (linear probing) hash indexes of
+ * twice the capacity, which stay short without tombstones as deletion shifts
+ * entries back. The addresses of a stored device must not be changed.
+ */
+
+#ifndef _DW1000DeviceTable_H_INCLUDED
+#define _DW1000DeviceTable_H_INCLUDED
+
+#include <Arduino.h>
+#include "DW1000Device.h"
+
+template<uint16_t CAPACITY>
+class DW1000DeviceTable {
+public:
+	typedef int16_t Handle;
+	static constexpr Handle INVALID_HANDLE = -1;
+
+	static_assert(CAPACITY > 0 && CAPACITY <= 0x3FFF, "device table capacity out of range");
+
+	DW1000DeviceTable() { clear(); }
+
+	void clear() {
+		_size = 0;
+		for(uint16_t i = 0; i < CAPACITY; i++) {
+			// positions above size hold the free handles
+			_handles[i]  = i;
+			_position[i] = INVALID_HANDLE;
+		}
+		for(uint16_t i = 0; i < INDEX_SIZE; i++) {
+			_shortIndex[i]   = INVALID_HANDLE;
+			_addressIndex[i] = INVALID_HANDLE;
+		}
+	}
+
+	uint16_t size() const { return _size; }
+	static constexpr uint16_t capacity() { return CAPACITY; }
+	boolean isFull() const { return _size == CAPACITY; }
+
+	/**
+	Stores a copy of the device and hands out a handle for it.
+
+	@return The stored device or `nullptr` if the table is full.
+	*/
+	DW1000Device* add(const DW1000Device& device) {
+		if(isFull()) {
+			return nullptr;
+		}
+		Handle handle = _handles[_size];
+		DW1000Device* stored = &_devices[_size];
+		*stored = device;
+		stored->setIndex(handle);
+		_position[handle] = _size++;
+		insert(_shortIndex, shortHash(stored->getByteShortAddress()), handle);
+		insert(_addressIndex, addressHash(stored->getByteAddress()), handle);
+		return stored;
+	}
+
+	// removes the device, the device at the last position moves into its place
+	boolean remove(Handle handle) {
+		DW1000Device* device = get(handle);
+		if(device == nullptr) {
+			return false;
+		}
+		erase(_shortIndex, handle, true);
+		erase(_addressIndex, handle, false);
+		uint16_t position = _position[handle];
+		uint16_t last     = --_size;
+		if(position != last) {
+			_devices[position] = _devices[last];
+			_handles[position] = _handles[last];
+			_position[_handles[position]] = position;
+		}
+		_handles[last]    = handle;
+		_position[handle] = INVALID_HANDLE;
+		return true;
+	}
+
+	boolean remove(DW1000Device* device) { return device != nullptr && remove(device->getIndex()); }
+
+	// device of a handle, `nullptr` if it was removed
+	DW1000Device* get(Handle handle) {
+		if(handle < 0 || handle >= (Handle)CAPACITY || _position[handle] == INVALID_HANDLE) {
+			return nullptr;
+		}
+		return &_devices[_position[handle]];
+	}
+
+	DW1000Device* findByShortAddress(const byte shortAddress[]) {
+		for(uint16_t i = shortHash(shortAddress);; i = (i+1) & INDEX_MASK) {
+			Handle handle = _shortIndex[i];
+			if(handle == INVALID_HANDLE) {
+				return nullptr;
+			}
+			DW1000Device* device = &_devices[_position[handle]];
+			if(memcmp(device->getByteShortAddress(), shortAddress, 2) == 0) {
+				return device;
+			}
+		}
+	}
+
+	DW1000Device* findByAddress(const byte address[]) {
+		for(uint16_t i = addressHash(address);; i = (i+1) & INDEX_MASK) {
+			Handle handle = _addressIndex[i];
+			if(handle == INVALID_HANDLE) {
+				return nullptr;
+			}
+			DW1000Device* device = &_devices[_position[handle]];
+			if(memcmp(device->getByteAddress(), address, 8) == 0) {
+				return device;
+			}
+		}
+	}
+
+	// devices by position (0 to size()-1), e.g. to iterate
+	DW1000Device& operator[](uint16_t position) { return _devices[position]; }
+	uint16_t positionOf(const DW1000Device* device) const { return device-_devices; }
+
+private:
+	// smallest power of two of at least twice the capacity
+	static constexpr uint8_t indexBits(uint16_t n, uint8_t bits = 1) {
+		return (1U << bits) >= 2U*n ? bits : indexBits(n, bits+1);
+	}
+	static constexpr uint8_t  INDEX_BITS = indexBits(CAPACITY);
+	static constexpr uint16_t INDEX_SIZE = 1U << INDEX_BITS;
+	static constexpr uint16_t INDEX_MASK = INDEX_SIZE-1;
+
+	DW1000Device _devices[CAPACITY];
+	// handle of each position, the ones from _size on are free
+	Handle       _handles[CAPACITY];
+	// position of each handle
+	Handle       _position[CAPACITY];
+	Handle       _shortIndex[INDEX_SIZE];
+	Handle       _addressIndex[INDEX_SIZE];
+	uint16_t     _size;
+
+	static uint16_t mix(uint16_t key) {
+		// multiplicative hashing (2^16 / golden ratio), the upper bits are the best mixed
+		return (uint16_t)(key*40503U) >> (16-INDEX_BITS);
+	}
+
+	static uint16_t shortHash(const byte shortAddress[]) {
+		return mix(shortAddress[0] | (uint16_t)shortAddress[1] << 8);
+	}
+
+	static uint16_t addressHash(const byte address[]) {
+		uint16_t key = 0;
+		for(uint8_t i = 0; i < 8; i += 2) {
+			key ^= address[i] | (uint16_t)address[i+1] << 8;
+			key = key << 5 | key >> 11;
+		}
+		return mix(key);
+	}
+
+	uint16_t home(Handle handle, boolean byShortAddress) {
+		DW1000Device* device = &_devices[_position[handle]];
+		return byShortAddress ? shortHash(device->getByteShortAddress()) : addressHash(device->getByteAddress());
+	}
+
+	static void insert(Handle index[], uint16_t slot, Handle handle) {
+		// there is always a free slot, the index is twice the capacity
+		while(index[slot] != INVALID_HANDLE) {
+			slot = (slot+1) & INDEX_MASK;
+		}
+		index[slot] = handle;
+	}
+
+	void erase(Handle index[], Handle handle, boolean byShortAddress) {
+		uint16_t slot = home(handle, byShortAddress);
+		while(index[slot] != handle) {
+			slot = (slot+1) & INDEX_MASK;
+		}
+		// shift back the following entries of the cluster which may not stay behind the gap
+		for(uint16_t next = (slot+1) & INDEX_MASK; index[next] != INVALID_HANDLE; next = (next+1) & INDEX_MASK) {
+			uint16_t nextHome = home(index[next], byShortAddress);
+			// distance from the home slot is less than the one to the gap: must stay
+			if(((next-nextHome) & INDEX_MASK) < ((next-slot) & INDEX_MASK)) {
+				continue;
+			}
+			index[slot] = index[next];
+			slot = next;
+		}
+		index[slot] = INVALID_HANDLE;
+	}
+};
+
+template<uint16_t CAPACITY>
+constexpr typename DW1000DeviceTable<CAPACITY>::Handle DW1000DeviceTable<CAPACITY>::INVALID_HANDLE;
+
+#endif
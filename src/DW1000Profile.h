@@ -0,0 +1,119 @@
+/*
+ * Decawave DW1000 library for arduino.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file DW1000Profile.h
+ * Complete radio configuration (channel, PRF, preamble code and length, PAC,
+ * SFD and data rate) that is validated while it is constructed.
+ *
+ * @note
+ * Declare profiles `constexpr`, then an illegal combination does not compile
+ * (a profile built at run time reports it with `isValid()`):
+ *
+ *     constexpr DW1000Profile myProfile(DW1000Class::CHANNEL_2, DW1000Class::TX_PULSE_FREQ_64MHZ,
+ *         DW1000Class::PREAMBLE_CODE_64MHZ_9, DW1000Class::TX_PREAMBLE_LEN_1024, DW1000Class::PAC_SIZE_32,
+ *         DW1000Profile::SFD_DECAWAVE, DW1000Class::TRX_RATE_850KBPS);
+ *     DW1000.enableMode(myProfile);
+ *
+ * The encodings are the same as the ones of the DW1000Class constants.
+ */
+
+#ifndef DW1000PROFILE_H
+#define DW1000PROFILE_H
+
+#include <Arduino.h>
+#include "require_cpp11.h"
+
+/**
+ * Not constexpr on purpose: a profile evaluated at compile time fails to compile
+ * when it reaches this function, i.e. when its settings do not go together.
+ * At run time it marks the offending setting as DW1000Profile::INVALID.
+ */
+byte DW1000Profile_illegal_combination_of_settings();
+
+struct DW1000Profile {
+	/* start frame delimiter: IEEE 802.15.4 standard at 6.8 Mb/s, Decawave below (the receiver is tuned for it). */
+	static constexpr byte SFD_STANDARD = 0x00;
+	static constexpr byte SFD_DECAWAVE = 0x01;
+	/* value of a setting that does not go with the others (0 is a valid value of most settings). */
+	static constexpr byte INVALID      = 0xFF;
+
+	byte channel;
+	byte pulseFrequency;
+	byte preambleCode;
+	byte preambleLength;
+	byte pacSize;
+	byte sfd;
+	byte dataRate;
+
+	constexpr DW1000Profile(byte channel, byte pulseFrequency, byte preambleCode, byte preambleLength,
+	                        byte pacSize, byte sfd, byte dataRate)
+		: channel(checked(isValidChannel(channel), channel)),
+		  pulseFrequency(checked(pulseFrequency == 0x01 || pulseFrequency == 0x02, pulseFrequency)),
+		  preambleCode(checked(isValidPreambleCode(channel, pulseFrequency, preambleCode), preambleCode)),
+		  preambleLength(checked(isValidPreambleLength(preambleLength, dataRate), preambleLength)),
+		  pacSize(checked(isValidPacSize(pacSize, preambleLength), pacSize)),
+		  sfd(checked(isValidSfd(sfd, dataRate), sfd)),
+		  dataRate(checked(dataRate <= 0x02, dataRate)) {
+	}
+
+	// `false` if a setting of a profile built at run time did not go with the others
+	constexpr bool isValid() const {
+		return channel != INVALID && pulseFrequency != INVALID && preambleCode != INVALID &&
+		       preambleLength != INVALID && pacSize != INVALID && sfd != INVALID && dataRate != INVALID;
+	}
+
+private:
+	static constexpr byte checked(bool valid, byte value) {
+		return valid ? value : DW1000Profile_illegal_combination_of_settings();
+	}
+
+	static constexpr bool isValidChannel(byte channel) {
+		return (channel >= 1 && channel <= 5) || channel == 7;
+	}
+
+	// see DW1000 user manual, chapter 10.5, table 61
+	static constexpr bool isValidPreambleCode(byte channel, byte pulseFrequency, byte code) {
+		return pulseFrequency == 0x01
+			? (channel == 1 ? (code == 1 || code == 2) :
+			   channel == 2 || channel == 5 ? (code == 3 || code == 4) :
+			   channel == 3 ? (code == 5 || code == 6) :
+			   (code == 7 || code == 8))
+			: (channel == 4 || channel == 7 ? (code >= 17 && code <= 20) : (code >= 9 && code <= 12));
+	}
+
+	// the receiver can only be tuned for these combinations (see DRX_TUNE1b)
+	static constexpr bool isValidPreambleLength(byte preambleLength, byte dataRate) {
+		return preambleLength == 0x01 ? dataRate == 0x02 :
+		       preambleLength == 0x05 || preambleLength == 0x09 || preambleLength == 0x0D || preambleLength == 0x02
+		           ? (dataRate == 0x01 || dataRate == 0x02) :
+		       preambleLength == 0x06 || preambleLength == 0x0A || preambleLength == 0x03 ? dataRate == 0x00 :
+		       false;
+	}
+
+	// the SFD follows the data rate (see DW1000Class::setDataRate()), so does the tuning of the receiver (DRX_TUNE0b)
+	static constexpr bool isValidSfd(byte sfd, byte dataRate) {
+		return dataRate == 0x02 ? sfd == SFD_STANDARD : sfd == SFD_DECAWAVE;
+	}
+
+	// PAC sizes larger than recommended for a preamble length (see user manual, table 6) do not work
+	static constexpr bool isValidPacSize(byte pacSize, byte preambleLength) {
+		return (pacSize == 8 || pacSize == 16 || pacSize == 32 || pacSize == 64) &&
+		       pacSize <= (preambleLength == 0x01 || preambleLength == 0x05 ? 8 :
+		                   preambleLength == 0x09 || preambleLength == 0x0D ? 16 :
+		                   preambleLength == 0x02 ? 32 : 64);
+	}
+};
+
+#endif // DW1000PROFILE_H
@@ -32,6 +32,7 @@
 #include "DW1000.h"
 #include "DW1000Time.h"
 #include "DW1000Device.h" 
+#include "DW1000DeviceTable.h"
 #include "DW1000Mac.h"
 
 // messages used in the ranging protocol
@@ -45,8 +46,15 @@
 
 #define LEN_DATA 90
 
-//Max devices we put in the networkDevices array ! Each DW1000Device is 74 Bytes in SRAM memory for now.
+//Max devices we put in the networkDevices table of DW1000Ranging ! Each DW1000Device is about 110 Bytes in SRAM memory
+//for now, see DW1000RangingClass::printMemoryReport(). Can be raised at compile time, e.g. for an anchor serving many
+//tags, or set per instance with DW1000RangingTemplate.
+#ifndef MAX_DEVICES
 #define MAX_DEVICES 4
+#endif
+
+//Max anchors a tag ranges with in one round, as many as fit into a RANGE frame (of LEN_DATA bytes)
+#define MAX_RANGING_DEVICES ((LEN_DATA-SHORT_MAC_LEN-2)/17)
 
 //Default Pin for module:
 #define DEFAULT_RST_PIN 9
@@ -61,21 +69,83 @@
 //sketch type (anchor or tag)
 #define TAG 0
 #define ANCHOR 1
+//role decided at runtime by startAsAnchor()/startAsTag(), only for DW1000RangingTemplate
+#define TAG_OR_ANCHOR 2
 
 //default timer delay
 #define DEFAULT_TIMER_DELAY 80
 
+//channel hopping (channel sets are bit masks, bit n for channel n)
+#define HOP_CHANNELS_DEFAULT 0x2E // channels 1, 2, 3 and 5
+#define HOP_CHANNELS_ALL 0xBE // additionally the wide band channels 4 and 7
+//every n-th round is on the home channel, so anchors that lost track can catch up
+#define HOP_RESYNC_ROUNDS 8
+//rounds per channel after which its success rate is checked
+#define HOP_STATS_WINDOW 16
+//channels with a lower success rate (in %) are blacklisted
+#define HOP_MIN_SUCCESS_RATE 50
+//rounds after which blacklisted channels get another chance
+#define HOP_BLACKLIST_ROUNDS 512
+
+//crystal trimming towards a reference device
+#define TRIM_REFERENCE_ANY 0xFFFF
+//frames the clock offset is averaged over before the trim is adjusted
+#define TRIM_WINDOW 16
+//offsets below this (in ppm) are left alone, one trim step is about 1.5 ppm
+#define TRIM_DEADBAND_PPM 1.0f
+
 //debug mode
 #ifndef DEBUG
 #define DEBUG false
 #endif
 
 
-class DW1000RangingClass {
+// ranging statistics of one channel (see DW1000RangingClass::useChannelHopping())
+struct ChannelStatistics {
+	uint16_t rounds;    // ranging rounds on the channel (since the last check)
+	uint16_t successes; // rounds that delivered a range
+	float    quality;   // smoothed receive quality, see DW1000Class::getReceiveQuality()
+};
+
+// residual clock offset to the reference device (see DW1000RangingClass::useCrystalTrimming())
+struct ClockTrimStatistics {
+	float    residualOffset; // mean offset over the last window in ppm
+	float    smoothedOffset; // residual offset smoothed over the windows in ppm
+	uint16_t windows;        // evaluated windows
+	uint16_t adjustments;    // trim changes
+};
+
+/**
+Ranging protocol, sized and specialized at compile time.
+
+@tparam ROLE TAG, ANCHOR or TAG_OR_ANCHOR. With a fixed role the role checks are constants,
+             so the code of the other role is dropped (and starting as the other role fails to compile).
+@tparam CAPACITY Size of the device table (tags of an anchor or anchors of a tag).
+@tparam LEN Size of the frame buffer, limits the anchors a tag ranges with (getMaxRangingDevices()).
+            At most LEN_UWB_FRAMES-2 (125), ranging uses standard frames.
+
+DW1000RangingClass (the global DW1000Ranging) is TAG_OR_ANCHOR with MAX_DEVICES and LEN_DATA, e.g.
+a tag only firmware uses its own instance instead:
+
+    DW1000RangingTemplate<TAG, 4, LEN_DATA> Ranging;
+
+An anchor keeps the protocol state per tag, so exchanges of several tags may interleave. This is best
+effort: each tag picks the reply slots of its anchors on its own (by their position in its table), the
+anchor does not assign them. Two tags that poll the same anchor at the same time in the same slot
+collide, and a POLL that arrives while the anchor waits for a delayed send is lost. The failed
+exchange is repeated in the next round of that tag.
+*/
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+class DW1000RangingTemplate {
 public:
+	static_assert(ROLE == TAG || ROLE == ANCHOR || ROLE == TAG_OR_ANCHOR, "unknown ranging role");
+	static_assert(LEN >= SHORT_MAC_LEN+2+17 && LEN >= LONG_MAC_LEN+4, "frame buffer too small to range");
+	// the ranging protocol does not enable extended frames, 2 bytes of a frame are the CRC
+	static_assert(LEN <= LEN_UWB_FRAMES-2, "frame buffer larger than a frame");
+	
 	//variables
 	// data buffer
-	static byte data[LEN_DATA];
+	static byte data[LEN];
 	
 	//initialisation
 	static void    initCommunication(uint8_t myRST = DEFAULT_RST_PIN, uint8_t mySS = DEFAULT_SPI_SS_PIN, uint8_t myIRQ = 2);
@@ -85,18 +155,52 @@ public:
 	static void    startAsTag(char address[], const byte mode[], const bool randomShortAddress = true);
 	static boolean addNetworkDevices(DW1000Device* device, boolean shortAddress);
 	static boolean addNetworkDevices(DW1000Device* device);
+	// removes the device at the given position (0 to getNetworkDevicesNumber()-1)
 	static void    removeNetworkDevices(int16_t index);
 	
 	//setters
 	static void setReplyTime(uint16_t replyDelayTimeUs);
 	static void setResetPeriod(uint32_t resetPeriod);
+	// hardware frame filtering (enabled by default), needs to be set before startAsAnchor()/startAsTag()
+	static void useFrameFilter(boolean enabled);
+	// low duty-cycle receive for (battery powered) anchors, see DW1000Class::setSniffMode(). offTimeUs 0 disables it.
+	static void useSniffMode(byte onTimePacs, byte offTimeUs);
+	// hop between the given channels (bit n for channel n, 0 disables) from ranging round to ranging round.
+	// Anchors announce channels and seed in RANGING_INIT, tags only need to enable hopping and then follow.
+	// The channel of the mode started with is the home channel, blinks and every HOP_RESYNC_ROUNDS-th round use it.
+	// An anchor only hops while it serves a single tag. Once a second tag joins, it stays on the home channel
+	// (until all tags are gone) and tells the joining tags not to hop; a tag that already hops only gets
+	// through on the home channel until it joins again.
+	// Needs to be set before startAsAnchor()/startAsTag().
+	static void useChannelHopping(byte channels, uint16_t seed = 0xDECA);
+	// trim our crystal so that our clock follows the one of the reference device (short address as returned
+	// by DW1000Device::getShortAddress(), or TRIM_REFERENCE_ANY). The reference itself must not trim.
+	static void useCrystalTrimming(boolean enabled, uint16_t referenceShortAddress = TRIM_REFERENCE_ANY);
 	
 	//getters
 	static byte* getCurrentAddress() { return _currentAddress; };
 	
 	static byte* getCurrentShortAddress() { return _currentShortAddress; };
 	
-	static uint8_t getNetworkDevicesNumber() { return _networkDevicesNumber; };
+	static uint16_t getNetworkDevicesNumber() { return _networkDevices.size(); };
+	
+	// anchors a tag ranges with in one round, as many as fit into a RANGE frame
+	static constexpr uint16_t getMaxRangingDevices() { return (LEN-SHORT_MAC_LEN-2)/17; };
+	
+	// number of frames the hardware frame filter dropped since start
+	static uint16_t getDroppedFramesCount();
+	
+	// channel hopping state and per channel statistics
+	static byte getCurrentChannel() { return DW1000.getChannel(); };
+	
+	static byte getChannelBlacklist() { return _hopBlacklist; };
+	
+	static const ChannelStatistics& getChannelStatistics(byte channel) { return _channelStats[channel & 0x07]; };
+	
+	static const ClockTrimStatistics& getClockTrimStatistics() { return _trimStats; };
+	
+	// SRAM used by the device table and ranging buffers of this build, to size CAPACITY per target
+	static void printMemoryReport(Print& out);
 	
 	//ranging functions
 	static int16_t detectMessageType(byte datas[]); // TODO check return type
@@ -125,9 +229,8 @@ public:
 
 private:
 	//other devices in the network
-	static DW1000Device _networkDevices[MAX_DEVICES];
-	static volatile uint8_t _networkDevicesNumber;
-	static int16_t      _lastDistantDevice;
+	static DW1000DeviceTable<CAPACITY> _networkDevices;
+	static int16_t      _lastDistantDevice; // handle in _networkDevices
 	static byte         _currentAddress[8];
 	static byte         _currentShortAddress[2];
 	static byte         _lastSentToShortAddress[2];
@@ -141,16 +244,18 @@ private:
 	static void (* _handleNewDevice)(DW1000Device*);
 	static void (* _handleInactiveDevice)(DW1000Device*);
 	
-	//sketch type (tag or anchor)
+	//sketch type (tag or anchor), only used for TAG_OR_ANCHOR
 	static int16_t          _type; //0 for tag and 1 for anchor
+	static bool isAnchor() { return ROLE == ANCHOR || (ROLE == TAG_OR_ANCHOR && _type == ANCHOR); }
+	static bool isTag() { return ROLE == TAG || (ROLE == TAG_OR_ANCHOR && _type == TAG); }
+	// an anchor follows the rounds of one tag only, with more tags it stays on the home channel
+	static bool isHopping() { return _hopChannels != 0 && (isTag() || !_hopSuspended); }
 	// TODO check type, maybe enum?
-	// message flow state
+	// message flow state of a tag (an anchor keeps it per tag, see DW1000Device::getExpectedMessage())
 	static volatile byte    _expectedMsgId;
 	// message sent/received state
 	static volatile boolean _sentAck;
 	static volatile boolean _receivedAck;
-	// protocol error state
-	static boolean          _protocolFailed;
 	// reset line to the chip
 	static uint8_t     _RST;
 	static uint8_t     _SS;
@@ -159,6 +264,28 @@ private:
 	static uint32_t    _resetPeriod;
 	// reply times (same on both sides for symm. ranging)
 	static uint16_t     _replyDelayTimeUS;
+	// hardware frame filtering
+	static boolean      _useFrameFilter;
+	// low duty-cycle receive settings
+	static byte         _sniffOnTime;
+	static byte         _sniffOffTime;
+	// channel hopping
+	static byte         _hopChannels;
+	static uint16_t     _hopSeed;
+	static uint16_t     _hopRound;
+	static byte         _hopBlacklist;
+	static uint16_t     _hopBlacklistAge;
+	static byte         _homeChannel;
+	static byte         _homePreambleCode;
+	static boolean      _roundSucceeded;
+	static boolean      _hopSuspended; // anchor with several tags
+	static ChannelStatistics _channelStats[8];
+	// crystal trimming
+	static boolean      _useCrystalTrimming;
+	static uint16_t     _trimReference;
+	static float        _trimOffsetSum;
+	static uint8_t      _trimFrames;
+	static ClockTrimStatistics _trimStats;
 	//timer Tick delay
 	static uint16_t     _timerDelay;
 	// ranging counter (per second)
@@ -186,6 +313,17 @@ private:
 	static void checkForInactiveDevices();
 	static void copyShortAddress(byte address1[], byte address2[]);
 	
+	//channel hopping
+	static byte hopChannel(uint16_t round);
+	static void switchChannel(byte channel);
+	static void startRound();
+	static void checkChannel(byte channel);
+	static void noteQuality(float quality);
+	
+	//clock offset tracking
+	static void noteClockOffset(DW1000Device* device, float offset);
+	static void trimCrystal(float offset);
+	
 	//for ranging protocole (ANCHOR)
 	static void transmitInit();
 	static void transmit(byte datas[]);
@@ -210,6 +348,11 @@ private:
 	static float filterValue(float value, float previousValue, uint16_t numberOfElements);
 };
 
+typedef DW1000RangingTemplate<TAG_OR_ANCHOR, MAX_DEVICES, LEN_DATA> DW1000RangingClass;
+
+#include "DW1000RangingImpl.h"
+
+// the members of DW1000RangingClass (and its buffers) are only instantiated if a sketch uses it
 extern DW1000RangingClass DW1000Ranging;
 
 #endif
@@ -0,0 +1,1329 @@
+/*
+ * Copyright (c) 2015 by Thomas Trojer <thomas@trojer.net> and Leopold Sayous <leosayous@gmail.com>
+ * Decawave DW1000 library for arduino.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file DW1000RangingImpl.h
+ * Implementation of the DW1000RangingTemplate, included by DW1000Ranging.h.
+ * Sketches instantiate it with their own role and sizes, only what a sketch
+ * uses is compiled (also of the default DW1000RangingClass).
+ */
+
+#ifndef _DW1000RangingImpl_H_INCLUDED
+#define _DW1000RangingImpl_H_INCLUDED
+
+#include "DW1000Tof.h"
+
+//other devices we are going to communicate with which are on our network:
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+DW1000DeviceTable<CAPACITY> DW1000RangingTemplate<ROLE, CAPACITY, LEN>::_networkDevices;
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+byte         DW1000RangingTemplate<ROLE, CAPACITY, LEN>::_currentAddress[8];
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+byte         DW1000RangingTemplate<ROLE, CAPACITY, LEN>::_currentShortAddress[2];
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+byte         DW1000RangingTemplate<ROLE, CAPACITY, LEN>::_lastSentToShortAddress[2];
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+int16_t      DW1000RangingTemplate<ROLE, CAPACITY, LEN>::_lastDistantDevice    = 0; // TODO short, 8bit?
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+DW1000Mac    DW1000RangingTemplate<ROLE, CAPACITY, LEN>::_globalMac;
+
+//module type (anchor or tag)
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+int16_t      DW1000RangingTemplate<ROLE, CAPACITY, LEN>::_type; // TODO enum??
+
+// message flow state
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+volatile byte    DW1000RangingTemplate<ROLE, CAPACITY, LEN>::_expectedMsgId;
+
+// range filter
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+volatile boolean DW1000RangingTemplate<ROLE, CAPACITY, LEN>::_useRangeFilter = false;
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+uint16_t DW1000RangingTemplate<ROLE, CAPACITY, LEN>::_rangeFilterValue = 15;
+
+// message sent/received state
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+volatile boolean DW1000RangingTemplate<ROLE, CAPACITY, LEN>::_sentAck     = false;
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+volatile boolean DW1000RangingTemplate<ROLE, CAPACITY, LEN>::_receivedAck = false;
+
+// timestamps to remember
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+int32_t            DW1000RangingTemplate<ROLE, CAPACITY, LEN>::timer           = 0;
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+int16_t            DW1000RangingTemplate<ROLE, CAPACITY, LEN>::counterForBlink = 0; // TODO 8 bit?
+
+
+// data buffer
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+byte          DW1000RangingTemplate<ROLE, CAPACITY, LEN>::data[LEN];
+// reset line to the chip
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+uint8_t   DW1000RangingTemplate<ROLE, CAPACITY, LEN>::_RST;
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+uint8_t   DW1000RangingTemplate<ROLE, CAPACITY, LEN>::_SS;
+// watchdog and reset period
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+uint32_t  DW1000RangingTemplate<ROLE, CAPACITY, LEN>::_lastActivity;
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+uint32_t  DW1000RangingTemplate<ROLE, CAPACITY, LEN>::_resetPeriod;
+// reply times (same on both sides for symm. ranging)
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+uint16_t  DW1000RangingTemplate<ROLE, CAPACITY, LEN>::_replyDelayTimeUS;
+// hardware frame filtering (enabled by default)
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+boolean   DW1000RangingTemplate<ROLE, CAPACITY, LEN>::_useFrameFilter = true;
+// low duty-cycle receive (disabled by default)
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+byte      DW1000RangingTemplate<ROLE, CAPACITY, LEN>::_sniffOnTime  = 0;
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+byte      DW1000RangingTemplate<ROLE, CAPACITY, LEN>::_sniffOffTime = 0;
+// channel hopping (disabled by default)
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+byte      DW1000RangingTemplate<ROLE, CAPACITY, LEN>::_hopChannels      = 0;
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+uint16_t  DW1000RangingTemplate<ROLE, CAPACITY, LEN>::_hopSeed          = 0xDECA;
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+uint16_t  DW1000RangingTemplate<ROLE, CAPACITY, LEN>::_hopRound         = 0;
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+byte      DW1000RangingTemplate<ROLE, CAPACITY, LEN>::_hopBlacklist     = 0;
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+uint16_t  DW1000RangingTemplate<ROLE, CAPACITY, LEN>::_hopBlacklistAge  = 0;
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+byte      DW1000RangingTemplate<ROLE, CAPACITY, LEN>::_homeChannel;
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+byte      DW1000RangingTemplate<ROLE, CAPACITY, LEN>::_homePreambleCode;
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+boolean   DW1000RangingTemplate<ROLE, CAPACITY, LEN>::_roundSucceeded   = false;
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+boolean   DW1000RangingTemplate<ROLE, CAPACITY, LEN>::_hopSuspended     = false;
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+ChannelStatistics DW1000RangingTemplate<ROLE, CAPACITY, LEN>::_channelStats[8];
+// crystal trimming (disabled by default)
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+boolean   DW1000RangingTemplate<ROLE, CAPACITY, LEN>::_useCrystalTrimming = false;
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+uint16_t  DW1000RangingTemplate<ROLE, CAPACITY, LEN>::_trimReference      = TRIM_REFERENCE_ANY;
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+float     DW1000RangingTemplate<ROLE, CAPACITY, LEN>::_trimOffsetSum      = 0;
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+uint8_t   DW1000RangingTemplate<ROLE, CAPACITY, LEN>::_trimFrames         = 0;
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+ClockTrimStatistics DW1000RangingTemplate<ROLE, CAPACITY, LEN>::_trimStats;
+//timer delay
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+uint16_t  DW1000RangingTemplate<ROLE, CAPACITY, LEN>::_timerDelay;
+// ranging counter (per second)
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+uint16_t  DW1000RangingTemplate<ROLE, CAPACITY, LEN>::_successRangingCount = 0;
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+uint32_t  DW1000RangingTemplate<ROLE, CAPACITY, LEN>::_rangingCountPeriod  = 0;
+//Here our handlers
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+void (* DW1000RangingTemplate<ROLE, CAPACITY, LEN>::_handleNewRange)(void) = 0;
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+void (* DW1000RangingTemplate<ROLE, CAPACITY, LEN>::_handleBlinkDevice)(DW1000Device*) = 0;
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+void (* DW1000RangingTemplate<ROLE, CAPACITY, LEN>::_handleNewDevice)(DW1000Device*) = 0;
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+void (* DW1000RangingTemplate<ROLE, CAPACITY, LEN>::_handleInactiveDevice)(DW1000Device*) = 0;
+
+/* ###########################################################################
+ * #### Init and end #######################################################
+ * ######################################################################### */
+
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+void DW1000RangingTemplate<ROLE, CAPACITY, LEN>::initCommunication(uint8_t myRST, uint8_t mySS, uint8_t myIRQ) {
+	// reset line to the chip
+	_RST              = myRST;
+	_SS               = mySS;
+	_resetPeriod      = DEFAULT_RESET_PERIOD;
+	// reply times (same on both sides for symm. ranging)
+	_replyDelayTimeUS = DEFAULT_REPLY_DELAY_TIME;
+	//we set our timer delay
+	_timerDelay       = DEFAULT_TIMER_DELAY;
+	
+	
+	DW1000.begin(myIRQ, myRST);
+	DW1000.select(mySS);
+}
+
+
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+void DW1000RangingTemplate<ROLE, CAPACITY, LEN>::configureNetwork(uint16_t deviceAddress, uint16_t networkId, const byte mode[]) {
+	// general configuration
+	DW1000.newConfiguration();
+	DW1000.setDefaults();
+	DW1000.setDeviceAddress(deviceAddress);
+	DW1000.setNetworkId(networkId);
+	DW1000.enableMode(mode);
+	// let the chip drop frames that are not meant for us (anchors additionally need blinks)
+	if(!_useFrameFilter) {
+		DW1000.setFrameFilterPreset(DW1000.FRAME_FILTER_NONE);
+	} else if(isAnchor()) {
+		DW1000.setFrameFilterPreset(DW1000.FRAME_FILTER_ANCHOR);
+	} else {
+		DW1000.setFrameFilterPreset(DW1000.FRAME_FILTER_TAG);
+	}
+	DW1000.commitConfiguration();
+	// count the frames the hardware dropped
+	DW1000.enableEventCounters(_useFrameFilter);
+	// the configured channel is where blinks and resync rounds happen
+	_homeChannel      = DW1000.getChannel();
+	_homePreambleCode = DW1000.getPreambleCode();
+}
+
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+void DW1000RangingTemplate<ROLE, CAPACITY, LEN>::generalStart() {
+	// attach callback for (successfully) sent and received messages
+	DW1000.attachSentHandler(handleSent);
+	DW1000.attachReceivedHandler(handleReceived);
+	// anchor starts in receiving mode, awaiting a ranging poll message
+	
+	
+	if(DEBUG) {
+		// DEBUG monitoring
+		Serial.println("DW1000-arduino");
+		// initialize the driver
+		
+		
+		Serial.println("configuration..");
+		// DEBUG chip info and registers pretty printed
+		char msg[90];
+		DW1000.getPrintableDeviceIdentifier(msg);
+		Serial.print("Device ID: ");
+		Serial.println(msg);
+		DW1000.getPrintableExtendedUniqueIdentifier(msg);
+		Serial.print("Unique ID: ");
+		Serial.print(msg);
+		char string[6];
+		sprintf(string, "%02X:%02X", _currentShortAddress[0], _currentShortAddress[1]);
+		Serial.print(" short: ");
+		Serial.println(string);
+		
+		DW1000.getPrintableNetworkIdAndShortAddress(msg);
+		Serial.print("Network ID & Device Address: ");
+		Serial.println(msg);
+		DW1000.getPrintableDeviceMode(msg);
+		Serial.print("Device mode: ");
+		Serial.println(msg);
+	}
+	
+	
+	// anchor starts in receiving mode, awaiting a ranging poll message
+	receiver();
+	// for first time ranging frequency computation
+	_rangingCountPeriod = millis();
+}
+
+
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+void DW1000RangingTemplate<ROLE, CAPACITY, LEN>::startAsAnchor(char address[], const byte mode[], const bool randomShortAddress) {
+	static_assert(ROLE != TAG, "built as tag only");
+	//save the address
+	DW1000.convertToByte(address, _currentAddress);
+	//write the address on the DW1000 chip
+	DW1000.setEUI(address);
+	Serial.print("device address: ");
+	Serial.println(address);
+	if (randomShortAddress) {
+		//we need to define a random short address:
+		randomSeed(analogRead(0));
+		_currentShortAddress[0] = random(0, 256);
+		_currentShortAddress[1] = random(0, 256);
+	}
+	else {
+		// we use first two bytes in addess for short address
+		_currentShortAddress[0] = _currentAddress[0];
+		_currentShortAddress[1] = _currentAddress[1];
+	}
+	
+	//defined type as anchor (before configuring, frame filtering depends on it)
+	_type = ANCHOR;
+	
+	//we configur the network for mac filtering
+	//(device Address, network ID, frequency)
+	configureNetwork(_currentShortAddress[0]*256+_currentShortAddress[1], 0xDECA, mode);
+	
+	//general start:
+	generalStart();
+	
+	Serial.println("### ANCHOR ###");
+	
+}
+
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+void DW1000RangingTemplate<ROLE, CAPACITY, LEN>::startAsTag(char address[], const byte mode[], const bool randomShortAddress) {
+	static_assert(ROLE != ANCHOR, "built as anchor only");
+	//save the address
+	DW1000.convertToByte(address, _currentAddress);
+	//write the address on the DW1000 chip
+	DW1000.setEUI(address);
+	Serial.print("device address: ");
+	Serial.println(address);
+	if (randomShortAddress) {
+		//we need to define a random short address:
+		randomSeed(analogRead(0));
+		_currentShortAddress[0] = random(0, 256);
+		_currentShortAddress[1] = random(0, 256);
+	}
+	else {
+		// we use first two bytes in addess for short address
+		_currentShortAddress[0] = _currentAddress[0];
+		_currentShortAddress[1] = _currentAddress[1];
+	}
+	
+	//defined type as tag (before configuring, frame filtering depends on it)
+	_type = TAG;
+	
+	//we configur the network for mac filtering
+	//(device Address, network ID, frequency)
+	configureNetwork(_currentShortAddress[0]*256+_currentShortAddress[1], 0xDECA, mode);
+	
+	generalStart();
+	Serial.println("### TAG ###");
+}
+
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+boolean DW1000RangingTemplate<ROLE, CAPACITY, LEN>::addNetworkDevices(DW1000Device* device, boolean shortAddress) {
+	//we test our network devices table to check
+	//we don't already have it
+	if(shortAddress) {
+		if(_networkDevices.findByShortAddress(device->getByteShortAddress()) != nullptr) {
+			return false;
+		}
+	}
+	else if(_networkDevices.findByAddress(device->getByteAddress()) != nullptr) {
+		return false;
+	}
+	//a tag ranges with all its anchors in one RANGE frame
+	if(isTag() && _networkDevices.size() >= getMaxRangingDevices()) {
+		return false;
+	}
+	
+	device->setRange(0);
+	return _networkDevices.add(*device) != nullptr;
+}
+
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+boolean DW1000RangingTemplate<ROLE, CAPACITY, LEN>::addNetworkDevices(DW1000Device* device) {
+	//we test our network devices table to check
+	//we don't already have it
+	DW1000Device* known = _networkDevices.findByAddress(device->getByteAddress());
+	if(known != nullptr) {
+		if(known->isShortAddressEqual(device)) {
+			return false;
+		}
+		//the device restarted with a new short address
+		_networkDevices.remove(known);
+	}
+	if(_networkDevices.add(*device) == nullptr) {
+		return false;
+	}
+	//with several tags we stop hopping, until all of them are gone (see useChannelHopping())
+	if(_networkDevices.size() > 1) {
+		_hopSuspended = true;
+	}
+	return true;
+}
+
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+void DW1000RangingTemplate<ROLE, CAPACITY, LEN>::removeNetworkDevices(int16_t index) {
+	//the last device takes the place of the removed one, handles stay valid
+	_networkDevices.remove(_networkDevices[index].getIndex());
+	if(_networkDevices.size() == 0) {
+		_hopSuspended = false;
+	}
+}
+
+/* ###########################################################################
+ * #### Setters and Getters ##################################################
+ * ######################################################################### */
+
+//setters
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+void DW1000RangingTemplate<ROLE, CAPACITY, LEN>::setReplyTime(uint16_t replyDelayTimeUs) { _replyDelayTimeUS = replyDelayTimeUs; }
+
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+void DW1000RangingTemplate<ROLE, CAPACITY, LEN>::setResetPeriod(uint32_t resetPeriod) { _resetPeriod = resetPeriod; }
+
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+void DW1000RangingTemplate<ROLE, CAPACITY, LEN>::useFrameFilter(boolean enabled) {
+	_useFrameFilter = enabled;
+}
+
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+void DW1000RangingTemplate<ROLE, CAPACITY, LEN>::useChannelHopping(byte channels, uint16_t seed) {
+	_hopChannels = channels & HOP_CHANNELS_ALL;
+	_hopSeed     = seed;
+}
+
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+void DW1000RangingTemplate<ROLE, CAPACITY, LEN>::useCrystalTrimming(boolean enabled, uint16_t referenceShortAddress) {
+	_useCrystalTrimming = enabled;
+	_trimReference      = referenceShortAddress;
+	_trimOffsetSum      = 0;
+	_trimFrames         = 0;
+}
+
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+uint16_t DW1000RangingTemplate<ROLE, CAPACITY, LEN>::getDroppedFramesCount() {
+	return DW1000.getFrameFilterRejectCount();
+}
+
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+void DW1000RangingTemplate<ROLE, CAPACITY, LEN>::useSniffMode(byte onTimePacs, byte offTimeUs) {
+	_sniffOnTime  = onTimePacs;
+	_sniffOffTime = offTimeUs;
+}
+
+
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+void DW1000RangingTemplate<ROLE, CAPACITY, LEN>::printMemoryReport(Print& out) {
+	out.print(F("DW1000Device: "));
+	out.print(sizeof(DW1000Device));
+	out.print(F(" bytes (timestamps "));
+	out.print(6*sizeof(DW1000PackedTimestamp));
+	out.print(F(", clock tracker "));
+	out.print(sizeof(DW1000ClockTracker));
+	out.println(F(")"));
+	out.print(F("device table: "));
+	out.print(sizeof(_networkDevices));
+	out.print(F(" bytes for "));
+	out.print(CAPACITY);
+	out.print(F(" devices ("));
+	out.print((sizeof(_networkDevices)+CAPACITY/2)/CAPACITY);
+	out.println(F(" per device)"));
+	out.print(F("frame buffer: "));
+	out.print(sizeof(data));
+	out.println(F(" bytes"));
+	out.print(F("max. anchors per tag: "));
+	out.println(getMaxRangingDevices());
+}
+
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+DW1000Device* DW1000RangingTemplate<ROLE, CAPACITY, LEN>::searchDistantDevice(byte shortAddress[]) {
+	//hashed lookup of the 2 bytes address
+	return _networkDevices.findByShortAddress(shortAddress);
+}
+
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+DW1000Device* DW1000RangingTemplate<ROLE, CAPACITY, LEN>::getDistantDevice() {
+	//we get the device which correspond to the message which was sent (need to be filtered by MAC address)
+	
+	return _networkDevices.get(_lastDistantDevice);
+	
+}
+
+
+/* ###########################################################################
+ * #### Public methods #######################################################
+ * ######################################################################### */
+
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+void DW1000RangingTemplate<ROLE, CAPACITY, LEN>::checkForReset() {
+	uint32_t curMillis = millis();
+	if(!_sentAck && !_receivedAck) {
+		// check if inactive
+		if(curMillis-_lastActivity > _resetPeriod) {
+			resetInactive();
+		}
+		return; // TODO cc
+	}
+}
+
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+void DW1000RangingTemplate<ROLE, CAPACITY, LEN>::checkForInactiveDevices() {
+	for(uint16_t i = 0; i < _networkDevices.size();) {
+		if(_networkDevices[i].isInactive()) {
+			if(_handleInactiveDevice != 0) {
+				(*_handleInactiveDevice)(&_networkDevices[i]);
+			}
+			//we need to delete the device from the table, the last one moves to i:
+			removeNetworkDevices(i);
+			
+		}
+		else {
+			i++;
+		}
+	}
+}
+
+// TODO check return type
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+int16_t DW1000RangingTemplate<ROLE, CAPACITY, LEN>::detectMessageType(byte datas[]) {
+	if(datas[0] == FC_1_BLINK) {
+		return BLINK;
+	}
+	else if(datas[0] == FC_1 && datas[1] == FC_2) {
+		//we have a long MAC frame message (ranging init)
+		return datas[LONG_MAC_LEN];
+	}
+	else if(datas[0] == FC_1 && datas[1] == FC_2_SHORT) {
+		//we have a short mac frame message (poll, range, range report, etc..)
+		return datas[SHORT_MAC_LEN];
+	}
+}
+
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+void DW1000RangingTemplate<ROLE, CAPACITY, LEN>::loop() {
+	//we check if needed to reset !
+	checkForReset();
+	uint32_t time = millis(); // TODO other name - too close to "timer"
+	if(time-timer > _timerDelay) {
+		timer = time;
+		timerTick();
+	}
+	//temperature and voltage compensation, if enabled
+	DW1000.updateCompensation();
+	
+	if(_sentAck) {
+		_sentAck = false;
+		
+		// TODO cc
+		int messageType = detectMessageType(data);
+		
+		//the round is over for an anchor once it answered the RANGE, it moves on to the next channel
+		if(isAnchor() && isHopping() && (messageType == RANGE_REPORT || messageType == RANGE_FAILED)) {
+			switchChannel(hopChannel(_hopRound+1));
+			receiver();
+		}
+		
+		if(messageType != POLL_ACK && messageType != POLL && messageType != RANGE)
+			return;
+		
+		//A msg was sent. We launch the ranging protocole when a message was sent
+		if(isAnchor()) {
+			if(messageType == POLL_ACK) {
+				DW1000Device* myDistantDevice = searchDistantDevice(_lastSentToShortAddress);
+				
+				if (myDistantDevice) {
+					DW1000Timestamp timePollAckSent;
+					DW1000.getTransmitTimestamp(timePollAckSent);
+					myDistantDevice->timePollAckSent = timePollAckSent;
+				}
+			}
+		}
+		else if(isTag()) {
+			if(messageType == POLL) {
+				DW1000Timestamp timePollSent;
+				DW1000.getTransmitTimestamp(timePollSent);
+				//if the last device we send the POLL is broadcast:
+				if(_lastSentToShortAddress[0] == 0xFF && _lastSentToShortAddress[1] == 0xFF) {
+					//we save the value for all the devices !
+					for(uint16_t i = 0; i < _networkDevices.size(); i++) {
+						_networkDevices[i].timePollSent = timePollSent;
+					}
+				}
+				else {
+					//we search the device associated with the last send address
+					DW1000Device* myDistantDevice = searchDistantDevice(_lastSentToShortAddress);
+					//we save the value just for one device
+					if (myDistantDevice) {
+						myDistantDevice->timePollSent = timePollSent;
+					}
+				}
+			}
+			else if(messageType == RANGE) {
+				DW1000Timestamp timeRangeSent;
+				DW1000.getTransmitTimestamp(timeRangeSent);
+				//if the last device we send the POLL is broadcast:
+				if(_lastSentToShortAddress[0] == 0xFF && _lastSentToShortAddress[1] == 0xFF) {
+					//we save the value for all the devices !
+					for(uint16_t i = 0; i < _networkDevices.size(); i++) {
+						_networkDevices[i].timeRangeSent = timeRangeSent;
+					}
+				}
+				else {
+					//we search the device associated with the last send address
+					DW1000Device* myDistantDevice = searchDistantDevice(_lastSentToShortAddress);
+					//we save the value just for one device
+					if (myDistantDevice) {
+						myDistantDevice->timeRangeSent = timeRangeSent;
+					}
+				}
+				
+			}
+		}
+		
+	}
+	
+	//check for new received message
+	if(_receivedAck) {
+		_receivedAck = false;
+		
+		//we read the datas from the modules:
+		// get message and parse
+		DW1000.getData(data, LEN);
+		
+		int messageType = detectMessageType(data);
+		
+		//we have just received a BLINK message from tag
+		if(messageType == BLINK && isAnchor()) {
+			byte address[8];
+			byte shortAddress[2];
+			_globalMac.decodeBlinkFrame(data, address, shortAddress);
+			//we crate a new device with th tag
+			DW1000Device myTag(address, shortAddress);
+			
+			if(addNetworkDevices(&myTag)) {
+				if(_handleBlinkDevice != 0) {
+					(*_handleBlinkDevice)(&myTag);
+				}
+				//we reply by the transmit ranging init message
+				transmitRangingInit(&myTag);
+				noteActivity();
+			}
+		}
+		else if(messageType == RANGING_INIT && isTag()) {
+			
+			byte address[2];
+			_globalMac.decodeLongMACFrame(data, address);
+			//we crate a new device with the anchor
+			DW1000Device myAnchor(address, true);
+			
+			if(addNetworkDevices(&myAnchor, true)) {
+				if(_handleNewDevice != 0) {
+					(*_handleNewDevice)(&myAnchor);
+				}
+			}
+			//we follow the hopping sequence of the anchor
+			if(_hopChannels != 0) {
+				memcpy(&_hopSeed, data+LONG_MAC_LEN+1, 2);
+				_hopChannels = data[LONG_MAC_LEN+3] & HOP_CHANNELS_ALL;
+			}
+			
+			noteActivity();
+		}
+		else {
+			//we have a short mac layer frame !
+			byte address[2];
+			_globalMac.decodeShortMACFrame(data, address);
+			
+			
+			
+			//we get the device which correspond to the message which was sent (need to be filtered by MAC address)
+			DW1000Device* myDistantDevice = searchDistantDevice(address);
+			
+			
+			if((_networkDevices.size() == 0) || (myDistantDevice == nullptr)) {
+				//we don't have the short address of the device in memory
+				if (DEBUG) {
+					Serial.println("Not found");
+					/*
+					Serial.print("unknown: ");
+					Serial.print(address[0], HEX);
+					Serial.print(":");
+					Serial.println(address[1], HEX);
+					*/
+				}
+				return;
+			}
+			
+			
+			//then we proceed to range protocole
+			if(isAnchor()) {
+				//every tag has its own exchange, so exchanges of several tags can interleave (best effort, see class)
+				if(messageType != myDistantDevice->getExpectedMessage()) {
+					// unexpected message, start over again (except if already POLL)
+					myDistantDevice->setProtocolFailed(true);
+				}
+				if(messageType == POLL) {
+					//we receive a POLL which is a broacast message
+					//we need to grab info about it
+					int16_t numberDevices = 0;
+					memcpy(&numberDevices, data+SHORT_MAC_LEN+1, 1);
+					
+					for(uint16_t i = 0; i < numberDevices; i++) {
+						//we need to test if this value is for us:
+						//we grab the mac address of each devices:
+						byte shortAddress[2];
+						memcpy(shortAddress, data+SHORT_MAC_LEN+2+i*4, 2);
+						
+						//we test if the short address is our address
+						if(shortAddress[0] == _currentShortAddress[0] && shortAddress[1] == _currentShortAddress[1]) {
+							//we grab the replytime wich is for us
+							uint16_t replyTime;
+							memcpy(&replyTime, data+SHORT_MAC_LEN+2+i*4+2, 2);
+							//we configure the replyTime of this exchange;
+							myDistantDevice->setReplyTime(replyTime);
+							
+							// on POLL we (re-)start, so no protocol failure
+							myDistantDevice->setProtocolFailed(false);
+							
+							//the tag tells us the round (and so the next channel) and the channels to avoid
+							if(_hopChannels != 0) {
+								memcpy(&_hopRound, data+SHORT_MAC_LEN+2+numberDevices*4, 2);
+								_hopBlacklist = data[SHORT_MAC_LEN+4+numberDevices*4];
+							}
+							_channelStats[DW1000.getChannel()].rounds++;
+							
+							DW1000Class::RxDiagnostics rxDiag;
+							DW1000.getReceiveDiagnostics(rxDiag);
+							DW1000Timestamp timePollReceived;
+							DW1000.getReceiveTimestamp(rxDiag, timePollReceived);
+							myDistantDevice->timePollReceived = timePollReceived;
+							noteClockOffset(myDistantDevice, DW1000.getClockOffset(rxDiag));
+							//we note activity for our device:
+							myDistantDevice->noteActivity();
+							//we indicate our next receive message for our ranging protocole
+							myDistantDevice->setExpectedMessage(RANGE);
+							transmitPollAck(myDistantDevice);
+							noteActivity();
+							
+							return;
+						}
+						
+					}
+					
+					
+				}
+				else if(messageType == RANGE) {
+					//we receive a RANGE which is a broacast message
+					//we need to grab info about it
+					uint8_t numberDevices = 0;
+					memcpy(&numberDevices, data+SHORT_MAC_LEN+1, 1);
+					
+					
+					for(uint8_t i = 0; i < numberDevices; i++) {
+						//we need to test if this value is for us:
+						//we grab the mac address of each devices:
+						byte shortAddress[2];
+						memcpy(shortAddress, data+SHORT_MAC_LEN+2+i*17, 2);
+						
+						//we test if the short address is our address
+						if(shortAddress[0] == _currentShortAddress[0] && shortAddress[1] == _currentShortAddress[1]) {
+							//we grab the receive diagnostics (timestamp, power, quality) at once
+							DW1000Class::RxDiagnostics rxDiag;
+							DW1000.getReceiveDiagnostics(rxDiag);
+							DW1000Timestamp timeRangeReceived;
+							DW1000.getReceiveTimestamp(rxDiag, timeRangeReceived);
+							myDistantDevice->timeRangeReceived = timeRangeReceived;
+							noteClockOffset(myDistantDevice, DW1000.getClockOffset(rxDiag));
+							noteActivity();
+							myDistantDevice->setExpectedMessage(POLL);
+							
+							if(!myDistantDevice->isProtocolFailed()) {
+								
+								myDistantDevice->timePollSent.setTimestamp(data+SHORT_MAC_LEN+4+17*i);
+								myDistantDevice->timePollAckReceived.setTimestamp(data+SHORT_MAC_LEN+9+17*i);
+								myDistantDevice->timeRangeSent.setTimestamp(data+SHORT_MAC_LEN+14+17*i);
+								
+								// both send timestamps of the tag and our receive timestamps update its clock model
+								DW1000ClockTracker& clockTracker = myDistantDevice->getClockTracker();
+								if(clockTracker.getSamples() == 0) {
+									clockTracker.reset(myDistantDevice->getClockOffset());
+								}
+								clockTracker.update(myDistantDevice->timePollReceived, myDistantDevice->timePollSent);
+								clockTracker.update(myDistantDevice->timeRangeReceived, myDistantDevice->timeRangeSent);
+								
+								// (re-)compute range as two-way ranging is done
+								DW1000Time myTOF;
+								computeRangeAsymmetric(myDistantDevice, &myTOF); // CHOSEN RANGING ALGORITHM
+								
+								float distance = myTOF.getAsMeters();
+								
+								if (_useRangeFilter) {
+									//Skip first range
+									if (myDistantDevice->getRange() != 0.0f) {
+										distance = filterValue(distance, myDistantDevice->getRange(), _rangeFilterValue);
+									}
+								}
+								
+								myDistantDevice->setRXPower(DW1000.getReceivePower(rxDiag));
+								myDistantDevice->setRange(distance);
+								
+								myDistantDevice->setFPPower(DW1000.getFirstPathPower(rxDiag));
+								myDistantDevice->setQuality(DW1000.getReceiveQuality(rxDiag));
+								
+								_channelStats[DW1000.getChannel()].successes++;
+								noteQuality(myDistantDevice->getQuality());
+								
+								//we send the range to TAG
+								transmitRangeReport(myDistantDevice);
+								
+								//we have finished our range computation. We send the corresponding handler
+								myDistantDevice->noteRange();
+								_lastDistantDevice = myDistantDevice->getIndex();
+								if(_handleNewRange != 0) {
+									(*_handleNewRange)();
+								}
+								
+							}
+							else {
+								transmitRangeFailed(myDistantDevice);
+							}
+							
+							
+							return;
+						}
+						
+					}
+					
+					
+				}
+			}
+			else if(isTag()) {
+				// get message and parse
+				if(messageType != _expectedMsgId) {
+					// unexpected message, start over again
+					//not needed ?
+					return;
+					_expectedMsgId = POLL_ACK;
+					return;
+				}
+				if(messageType == POLL_ACK) {
+					DW1000Class::RxDiagnostics rxDiag;
+					DW1000.getReceiveDiagnostics(rxDiag);
+					DW1000Timestamp timePollAckReceived;
+					DW1000.getReceiveTimestamp(rxDiag, timePollAckReceived);
+					myDistantDevice->timePollAckReceived = timePollAckReceived;
+					noteQuality(DW1000.getReceiveQuality(rxDiag));
+					noteClockOffset(myDistantDevice, DW1000.getClockOffset(rxDiag));
+					//we note activity for our device:
+					myDistantDevice->noteActivity();
+					
+					//in the case the message come from our last device:
+					if(_networkDevices.positionOf(myDistantDevice) == _networkDevices.size()-1) {
+						_expectedMsgId = RANGE_REPORT;
+						//and transmit the next message (range) of the ranging protocole (in broadcast)
+						transmitRange(nullptr);
+					}
+				}
+				else if(messageType == RANGE_REPORT) {
+					
+					float curRange;
+					memcpy(&curRange, data+1+SHORT_MAC_LEN, 4);
+					float curRXPower;
+					memcpy(&curRXPower, data+5+SHORT_MAC_LEN, 4);
+					
+					if (_useRangeFilter) {
+						//Skip first range
+						if (myDistantDevice->getRange() != 0.0f) {
+							curRange = filterValue(curRange, myDistantDevice->getRange(), _rangeFilterValue);
+						}
+					}
+
+					//we have a new range to save !
+					myDistantDevice->setRange(curRange);
+					myDistantDevice->setRXPower(curRXPower);
+					
+					//one range is enough for the round to count on its channel
+					if(!_roundSucceeded) {
+						_roundSucceeded = true;
+						_channelStats[DW1000.getChannel()].successes++;
+					}
+					
+					
+					//We can call our handler !
+					//we have finished our range computation. We send the corresponding handler
+					myDistantDevice->noteRange();
+					_lastDistantDevice = myDistantDevice->getIndex();
+					if(_handleNewRange != 0) {
+						(*_handleNewRange)();
+					}
+				}
+				else if(messageType == RANGE_FAILED) {
+					//not needed as we have a timer;
+					return;
+					_expectedMsgId = POLL_ACK;
+				}
+			}
+		}
+		
+	}
+}
+
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+void DW1000RangingTemplate<ROLE, CAPACITY, LEN>::useRangeFilter(boolean enabled) {
+	_useRangeFilter = enabled;
+}
+
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+void DW1000RangingTemplate<ROLE, CAPACITY, LEN>::setRangeFilterValue(uint16_t newValue) {
+	if (newValue < 2) {
+		_rangeFilterValue = 2;
+	}else{
+		_rangeFilterValue = newValue;
+	}
+}
+
+
+/* ###########################################################################
+ * #### Private methods and Handlers for transmit & Receive reply ############
+ * ######################################################################### */
+
+
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+void DW1000RangingTemplate<ROLE, CAPACITY, LEN>::handleSent() {
+	// status change on sent success
+	_sentAck = true;
+}
+
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+void DW1000RangingTemplate<ROLE, CAPACITY, LEN>::handleReceived() {
+	// status change on received success
+	_receivedAck = true;
+}
+
+
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+void DW1000RangingTemplate<ROLE, CAPACITY, LEN>::noteActivity() {
+	// update activity timestamp, so that we do not reach "resetPeriod"
+	_lastActivity = millis();
+}
+
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+void DW1000RangingTemplate<ROLE, CAPACITY, LEN>::resetInactive() {
+	//if inactive
+	if(isAnchor()) {
+		for(uint16_t i = 0; i < _networkDevices.size(); i++) {
+			_networkDevices[i].setExpectedMessage(POLL);
+		}
+		//lost track of the tags, wait for them on the home channel
+		if(_hopChannels != 0) {
+			switchChannel(_homeChannel);
+		}
+		receiver();
+	}
+	noteActivity();
+}
+
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+void DW1000RangingTemplate<ROLE, CAPACITY, LEN>::timerTick() {
+	if(_networkDevices.size() > 0 && counterForBlink != 0) {
+		if(isTag()) {
+			_expectedMsgId = POLL_ACK;
+			//next round, possibly on another channel
+			startRound();
+			//send a prodcast poll
+			transmitPoll(nullptr);
+		}
+	}
+	else if(counterForBlink == 0) {
+		if(isTag()) {
+			//blinks are sent on the home channel, where new anchors listen
+			if(_hopChannels != 0) {
+				switchChannel(_homeChannel);
+			}
+			transmitBlink();
+		}
+		//check for inactive devices if we are a TAG or ANCHOR
+		checkForInactiveDevices();
+	}
+	counterForBlink++;
+	if(counterForBlink > 20) {
+		counterForBlink = 0;
+	}
+}
+
+
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+void DW1000RangingTemplate<ROLE, CAPACITY, LEN>::copyShortAddress(byte address1[], byte address2[]) {
+	*address1     = *address2;
+	*(address1+1) = *(address2+1);
+}
+
+/* ###########################################################################
+ * #### Channel hopping ######################################################
+ * ######################################################################### */
+
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+byte DW1000RangingTemplate<ROLE, CAPACITY, LEN>::hopChannel(uint16_t round) {
+	byte channels = _hopChannels & ~_hopBlacklist;
+	if(channels == 0 || round % HOP_RESYNC_ROUNDS == 0) {
+		return _homeChannel;
+	}
+	// mix round and seed (16 bit on every platform, tags and anchors need the same result)
+	uint16_t mix = (uint16_t)((uint16_t)(round ^ _hopSeed) * 0x9E3Bu);
+	mix ^= mix >> 7;
+	uint8_t count = 0;
+	for(byte channel = 1; channel < 8; channel++) {
+		if(bitRead(channels, channel)) {
+			count++;
+		}
+	}
+	uint8_t pick = mix % count;
+	for(byte channel = 1; channel < 8; channel++) {
+		if(bitRead(channels, channel) && pick-- == 0) {
+			return channel;
+		}
+	}
+	return _homeChannel;
+}
+
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+void DW1000RangingTemplate<ROLE, CAPACITY, LEN>::switchChannel(byte channel) {
+	if(channel == DW1000.getChannel()) {
+		return;
+	}
+	// the home channel keeps the preamble code of the mode, the others use their default one
+	DW1000.switchChannel(channel, channel == _homeChannel ? _homePreambleCode : 0);
+}
+
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+void DW1000RangingTemplate<ROLE, CAPACITY, LEN>::startRound() {
+	if(_hopChannels != 0) {
+		byte previousChannel = DW1000.getChannel();
+		_hopRound++;
+		switchChannel(hopChannel(_hopRound));
+		// blacklist changes are announced in this round's POLL, so they apply from the next round on
+		checkChannel(previousChannel);
+		if(_hopBlacklist != 0 && ++_hopBlacklistAge >= HOP_BLACKLIST_ROUNDS) {
+			// blacklisted channels get another chance
+			_hopBlacklist = 0;
+		}
+	}
+	_channelStats[DW1000.getChannel()].rounds++;
+	_roundSucceeded = false;
+}
+
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+void DW1000RangingTemplate<ROLE, CAPACITY, LEN>::checkChannel(byte channel) {
+	ChannelStatistics& stats = _channelStats[channel];
+	if(stats.rounds < HOP_STATS_WINDOW) {
+		return;
+	}
+	if(channel != _homeChannel && (uint32_t)stats.successes*100 < (uint32_t)stats.rounds*HOP_MIN_SUCCESS_RATE) {
+		// the home channel is needed to resync, and we need at least one other channel to hop to
+		byte remaining = _hopChannels & ~_hopBlacklist & ~bit(channel) & ~bit(_homeChannel);
+		if(remaining != 0) {
+			if(_hopBlacklist == 0) {
+				_hopBlacklistAge = 0;
+			}
+			_hopBlacklist |= bit(channel);
+		}
+	}
+	stats.rounds    = 0;
+	stats.successes = 0;
+}
+
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+void DW1000RangingTemplate<ROLE, CAPACITY, LEN>::noteClockOffset(DW1000Device* device, float offset) {
+	if(device->getClockOffset() == 0.0f) {
+		device->setClockOffset(offset);
+	} else {
+		device->setClockOffset(filterValue(offset, device->getClockOffset(), TRIM_WINDOW));
+	}
+	if(_useCrystalTrimming && (_trimReference == TRIM_REFERENCE_ANY || _trimReference == device->getShortAddress())) {
+		trimCrystal(offset);
+	}
+}
+
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+void DW1000RangingTemplate<ROLE, CAPACITY, LEN>::trimCrystal(float offset) {
+	_trimOffsetSum += offset;
+	_trimFrames++;
+	if(_trimFrames < TRIM_WINDOW) {
+		return;
+	}
+	float residual = _trimOffsetSum/_trimFrames;
+	_trimOffsetSum = 0;
+	_trimFrames    = 0;
+	_trimStats.residualOffset = residual;
+	if(_trimStats.windows == 0) {
+		_trimStats.smoothedOffset = residual;
+	} else {
+		_trimStats.smoothedOffset = filterValue(residual, _trimStats.smoothedOffset, TRIM_WINDOW);
+	}
+	_trimStats.windows++;
+	// one step at a time, a higher trim slows our clock down
+	byte trim = DW1000.getCrystalTrim();
+	if(residual > TRIM_DEADBAND_PPM && trim > 0) {
+		DW1000.setCrystalTrim(trim-1);
+		_trimStats.adjustments++;
+	} else if(residual < -TRIM_DEADBAND_PPM && trim < FS_XTALT_MAX) {
+		DW1000.setCrystalTrim(trim+1);
+		_trimStats.adjustments++;
+	}
+}
+
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+void DW1000RangingTemplate<ROLE, CAPACITY, LEN>::noteQuality(float quality) {
+	ChannelStatistics& stats = _channelStats[DW1000.getChannel()];
+	if(stats.quality == 0.0f) {
+		stats.quality = quality;
+	} else {
+		stats.quality = filterValue(quality, stats.quality, HOP_STATS_WINDOW);
+	}
+}
+
+/* ###########################################################################
+ * #### Methods for ranging protocole   ######################################
+ * ######################################################################### */
+
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+void DW1000RangingTemplate<ROLE, CAPACITY, LEN>::transmitInit() {
+	DW1000.newTransmit();
+	DW1000.setDefaults();
+}
+
+
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+void DW1000RangingTemplate<ROLE, CAPACITY, LEN>::transmit(byte datas[]) {
+	DW1000.setData(datas, LEN);
+	DW1000.startTransmit();
+}
+
+
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+void DW1000RangingTemplate<ROLE, CAPACITY, LEN>::transmit(byte datas[], DW1000Time time) {
+	DW1000.setDelay(time);
+	DW1000.setData(data, LEN);
+	DW1000.startTransmit();
+}
+
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+void DW1000RangingTemplate<ROLE, CAPACITY, LEN>::transmitBlink() {
+	transmitInit();
+	_globalMac.generateBlinkFrame(data, _currentAddress, _currentShortAddress);
+	transmit(data);
+}
+
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+void DW1000RangingTemplate<ROLE, CAPACITY, LEN>::transmitRangingInit(DW1000Device* myDistantDevice) {
+	transmitInit();
+	//we generate the mac frame for a ranging init message
+	_globalMac.generateLongMACFrame(data, _currentShortAddress, myDistantDevice->getByteAddress());
+	//we define the function code
+	data[LONG_MAC_LEN] = RANGING_INIT;
+	//and announce our channel hopping sequence (none if we serve other tags already, the tag stops hopping then)
+	memcpy(data+LONG_MAC_LEN+1, &_hopSeed, 2);
+	data[LONG_MAC_LEN+3] = isHopping() ? _hopChannels : 0;
+	
+	copyShortAddress(_lastSentToShortAddress, myDistantDevice->getByteShortAddress());
+	
+	transmit(data);
+}
+
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+void DW1000RangingTemplate<ROLE, CAPACITY, LEN>::transmitPoll(DW1000Device* myDistantDevice) {
+	
+	transmitInit();
+	
+	if(myDistantDevice == nullptr) {
+		//we need to set our timerDelay:
+		_timerDelay = DEFAULT_TIMER_DELAY+(uint16_t)(_networkDevices.size()*3*DEFAULT_REPLY_DELAY_TIME/1000);
+		
+		byte shortBroadcast[2] = {0xFF, 0xFF};
+		_globalMac.generateShortMACFrame(data, _currentShortAddress, shortBroadcast);
+		data[SHORT_MAC_LEN]   = POLL;
+		//we enter the number of devices
+		data[SHORT_MAC_LEN+1] = _networkDevices.size();
+		
+		for(uint8_t i = 0; i < _networkDevices.size(); i++) {
+			//each devices have a different reply delay time.
+			_networkDevices[i].setReplyTime((2*i+1)*DEFAULT_REPLY_DELAY_TIME);
+			//we write the short address of our device:
+			memcpy(data+SHORT_MAC_LEN+2+4*i, _networkDevices[i].getByteShortAddress(), 2);
+			
+			//we add the replyTime
+			uint16_t replyTime = _networkDevices[i].getReplyTime();
+			memcpy(data+SHORT_MAC_LEN+2+2+4*i, &replyTime, 2);
+			
+		}
+		//we add the round and the channels to avoid (channel hopping)
+		memcpy(data+SHORT_MAC_LEN+2+4*_networkDevices.size(), &_hopRound, 2);
+		data[SHORT_MAC_LEN+4+4*_networkDevices.size()] = _hopBlacklist;
+		
+		copyShortAddress(_lastSentToShortAddress, shortBroadcast);
+		
+	}
+	else {
+		//we redefine our default_timer_delay for just 1 device;
+		_timerDelay = DEFAULT_TIMER_DELAY;
+		
+		_globalMac.generateShortMACFrame(data, _currentShortAddress, myDistantDevice->getByteShortAddress());
+		
+		data[SHORT_MAC_LEN]   = POLL;
+		data[SHORT_MAC_LEN+1] = 1;
+		uint16_t replyTime = myDistantDevice->getReplyTime();
+		memcpy(data+SHORT_MAC_LEN+2, &replyTime, sizeof(uint16_t)); // todo is code correct?
+		
+		copyShortAddress(_lastSentToShortAddress, myDistantDevice->getByteShortAddress());
+	}
+	
+	transmit(data);
+}
+
+
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+void DW1000RangingTemplate<ROLE, CAPACITY, LEN>::transmitPollAck(DW1000Device* myDistantDevice) {
+	transmitInit();
+	_globalMac.generateShortMACFrame(data, _currentShortAddress, myDistantDevice->getByteShortAddress());
+	data[SHORT_MAC_LEN] = POLL_ACK;
+	// delay as the ranging tag asked for in its POLL
+	DW1000Time deltaTime = DW1000Time(DW1000Time::microsecondsToTicks(myDistantDevice->getReplyTime()));
+	copyShortAddress(_lastSentToShortAddress, myDistantDevice->getByteShortAddress());
+	transmit(data, deltaTime);
+}
+
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+void DW1000RangingTemplate<ROLE, CAPACITY, LEN>::transmitRange(DW1000Device* myDistantDevice) {
+	//transmit range need to accept broadcast for multiple anchor
+	transmitInit();
+	
+	
+	if(myDistantDevice == nullptr) {
+		//we need to set our timerDelay:
+		_timerDelay = DEFAULT_TIMER_DELAY+(uint16_t)(_networkDevices.size()*3*DEFAULT_REPLY_DELAY_TIME/1000);
+		
+		byte shortBroadcast[2] = {0xFF, 0xFF};
+		_globalMac.generateShortMACFrame(data, _currentShortAddress, shortBroadcast);
+		data[SHORT_MAC_LEN]   = RANGE;
+		//we enter the number of devices
+		data[SHORT_MAC_LEN+1] = _networkDevices.size();
+		
+		// delay sending the message and remember expected future sent timestamp
+		DW1000Time deltaTime     = DW1000Time(DW1000Time::microsecondsToTicks(DEFAULT_REPLY_DELAY_TIME));
+		DW1000Timestamp timeRangeSent = DW1000Timestamp(DW1000.setDelay(deltaTime));
+		
+		for(uint8_t i = 0; i < _networkDevices.size(); i++) {
+			//we write the short address of our device:
+			memcpy(data+SHORT_MAC_LEN+2+17*i, _networkDevices[i].getByteShortAddress(), 2);
+			
+			
+			//we get the device which correspond to the message which was sent (need to be filtered by MAC address)
+			_networkDevices[i].timeRangeSent = timeRangeSent;
+			_networkDevices[i].timePollSent.getTimestamp(data+SHORT_MAC_LEN+4+17*i);
+			_networkDevices[i].timePollAckReceived.getTimestamp(data+SHORT_MAC_LEN+9+17*i);
+			_networkDevices[i].timeRangeSent.getTimestamp(data+SHORT_MAC_LEN+14+17*i);
+			
+		}
+		
+		copyShortAddress(_lastSentToShortAddress, shortBroadcast);
+		
+	}
+	else {
+		_globalMac.generateShortMACFrame(data, _currentShortAddress, myDistantDevice->getByteShortAddress());
+		data[SHORT_MAC_LEN] = RANGE;
+		// delay sending the message and remember expected future sent timestamp
+		DW1000Time deltaTime = DW1000Time(DW1000Time::microsecondsToTicks(_replyDelayTimeUS));
+		//we get the device which correspond to the message which was sent (need to be filtered by MAC address)
+		myDistantDevice->timeRangeSent = DW1000Timestamp(DW1000.setDelay(deltaTime));
+		myDistantDevice->timePollSent.getTimestamp(data+1+SHORT_MAC_LEN);
+		myDistantDevice->timePollAckReceived.getTimestamp(data+6+SHORT_MAC_LEN);
+		myDistantDevice->timeRangeSent.getTimestamp(data+11+SHORT_MAC_LEN);
+		copyShortAddress(_lastSentToShortAddress, myDistantDevice->getByteShortAddress());
+	}
+	
+	
+	transmit(data);
+}
+
+
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+void DW1000RangingTemplate<ROLE, CAPACITY, LEN>::transmitRangeReport(DW1000Device* myDistantDevice) {
+	transmitInit();
+	_globalMac.generateShortMACFrame(data, _currentShortAddress, myDistantDevice->getByteShortAddress());
+	data[SHORT_MAC_LEN] = RANGE_REPORT;
+	// write final ranging result
+	float curRange   = myDistantDevice->getRange();
+	float curRXPower = myDistantDevice->getRXPower();
+	//We add the Range and then the RXPower
+	memcpy(data+1+SHORT_MAC_LEN, &curRange, 4);
+	memcpy(data+5+SHORT_MAC_LEN, &curRXPower, 4);
+	copyShortAddress(_lastSentToShortAddress, myDistantDevice->getByteShortAddress());
+	transmit(data, DW1000Time(DW1000Time::microsecondsToTicks(myDistantDevice->getReplyTime())));
+}
+
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+void DW1000RangingTemplate<ROLE, CAPACITY, LEN>::transmitRangeFailed(DW1000Device* myDistantDevice) {
+	transmitInit();
+	_globalMac.generateShortMACFrame(data, _currentShortAddress, myDistantDevice->getByteShortAddress());
+	data[SHORT_MAC_LEN] = RANGE_FAILED;
+	
+	copyShortAddress(_lastSentToShortAddress, myDistantDevice->getByteShortAddress());
+	transmit(data);
+}
+
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+void DW1000RangingTemplate<ROLE, CAPACITY, LEN>::receiver() {
+	DW1000.newReceive();
+	DW1000.setDefaults();
+	// hunt for preambles with low duty-cycle if requested (applied by receivePermanently)
+	DW1000.setSniffMode(_sniffOnTime, _sniffOffTime);
+	// so we don't need to restart the receiver manually
+	DW1000.receivePermanently(true);
+	DW1000.startReceive();
+}
+
+
+/* ###########################################################################
+ * #### Methods for range computation and corrections  #######################
+ * ######################################################################### */
+
+
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+void DW1000RangingTemplate<ROLE, CAPACITY, LEN>::computeRangeAsymmetric(DW1000Device* myDistantDevice, DW1000Time* myTOF) {
+	// asymmetric two-way ranging (more computation intense, less error prone)
+	// the timestamps are 40 bit points in time, their differences are correct across the rollover
+	DW1000Timestamp pollSent        = myDistantDevice->timePollSent;
+	DW1000Timestamp pollReceived    = myDistantDevice->timePollReceived;
+	DW1000Timestamp pollAckSent     = myDistantDevice->timePollAckSent;
+	DW1000Timestamp pollAckReceived = myDistantDevice->timePollAckReceived;
+	DW1000Timestamp rangeSent       = myDistantDevice->timeRangeSent;
+	DW1000Timestamp rangeReceived   = myDistantDevice->timeRangeReceived;
+	DW1000Time round1 = pollAckReceived-pollSent;
+	DW1000Time reply1 = pollAckSent-pollReceived;
+	DW1000Time round2 = rangeReceived-pollAckSent;
+	DW1000Time reply2 = rangeSent-pollAckReceived;
+	
+	// no 64 bit overflow for any reply time, precision see DW1000TOF_PRECISION
+	myTOF->setTimestamp(DW1000Tof::computeAsymmetric(round1.getTimestamp(), reply1.getTimestamp(),
+	                                                 round2.getTimestamp(), reply2.getTimestamp()));
+	/*
+	Serial.print("timePollAckReceived ");myDistantDevice->timePollAckReceived.toTime().print();
+	Serial.print("timePollSent ");myDistantDevice->timePollSent.toTime().print();
+	Serial.print("round1 "); Serial.println((long)round1.getTimestamp());
+	
+	Serial.print("timePollAckSent ");myDistantDevice->timePollAckSent.toTime().print();
+	Serial.print("timePollReceived ");myDistantDevice->timePollReceived.toTime().print();
+	Serial.print("reply1 "); Serial.println((long)reply1.getTimestamp());
+	
+	Serial.print("timeRangeReceived ");myDistantDevice->timeRangeReceived.toTime().print();
+	Serial.print("timePollAckSent ");myDistantDevice->timePollAckSent.toTime().print();
+	Serial.print("round2 "); Serial.println((long)round2.getTimestamp());
+	
+	Serial.print("timeRangeSent ");myDistantDevice->timeRangeSent.toTime().print();
+	Serial.print("timePollAckReceived ");myDistantDevice->timePollAckReceived.toTime().print();
+	Serial.print("reply2 "); Serial.println((long)reply2.getTimestamp());
+	 */
+}
+
+
+/* FOR DEBUGGING*/
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+void DW1000RangingTemplate<ROLE, CAPACITY, LEN>::visualizeDatas(byte datas[]) {
+	char string[60];
+	sprintf(string, "%02X:%02X:%02X:%02X:%02X:%02X:%02X:%02X:%02X:%02X:%02X:%02X:%02X:%02X:%02X:%02X",
+					datas[0], datas[1], datas[2], datas[3], datas[4], datas[5], datas[6], datas[7], datas[8], datas[9], datas[10], datas[11], datas[12], datas[13], datas[14], datas[15]);
+	Serial.println(string);
+}
+
+
+
+/* ###########################################################################
+ * #### Utils  ###############################################################
+ * ######################################################################### */
+
+template<uint8_t ROLE, uint16_t CAPACITY, uint16_t LEN>
+float DW1000RangingTemplate<ROLE, CAPACITY, LEN>::filterValue(float value, float previousValue, uint16_t numberOfElements) {
+	
+	float k = 2.0f / ((float)numberOfElements + 1.0f);
+	return (value * k) + previousValue * (1.0f - k);
+}
+
+#endif
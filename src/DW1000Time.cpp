@@ -89,7 +89,7 @@ void DW1000Time::setTimestamp(int64_t value) {
  * Set timestamp
  * @param data timestamp as byte array
  */
-void DW1000Time::setTimestamp(byte data[]) {
+void DW1000Time::setTimestamp(const byte data[]) {
 	_timestamp = 0;
 	for(uint8_t i = 0; i < LENGTH_TIMESTAMP; i++) {
 		_timestamp |= ((int64_t)data[i] << (i*8));
@@ -117,14 +117,21 @@ void DW1000Time::setTime(float timeUs) {
 /**
  * Set DW100Time with time and factor
  * @param value time
- * @param factorUs multiply factor for time
- * @todo maybe replace by better function without float
+ * @param factorUs multiply factor for time, the predefined ones (e.g. MICROSECONDS)
+ * are converted exactly without float arithmetic
  */
 void DW1000Time::setTime(int32_t value, float factorUs) {
-	//float tsValue = value*factorUs;
-	//tsValue = fmod(tsValue, TIME_OVERFLOW);
-	//setTime(tsValue);
-	setTime(value*factorUs);
+	if(factorUs == MICROSECONDS) {
+		_timestamp = microsecondsToTicks(value);
+	} else if(factorUs == MILLISECONDS) {
+		_timestamp = millisecondsToTicks(value);
+	} else if(factorUs == NANOSECONDS) {
+		_timestamp = nanosecondsToTicks(value);
+	} else if(factorUs == SECONDS) {
+		_timestamp = value*TICKS_PER_SECOND;
+	} else {
+		setTime(value*factorUs);
+	}
 }
 
 /**
@@ -146,6 +153,14 @@ void DW1000Time::getTimestamp(byte data[]) const {
 	}
 }
 
+/**
+ * Same as time % TIME_OVERFLOW (the sign is kept), but with a mask instead of a
+ * 64 bit division, which is a slow library call on 8 bit MCUs
+ */
+static inline int64_t reduced(int64_t time) {
+	return time < 0 ? -(int64_t)((uint64_t)-time & DW1000Time::TIME_MAX) : (int64_t)((uint64_t)time & DW1000Time::TIME_MAX);
+}
+
 /**
  * Return real time in micro seconds
  * @return time in micro seconds
@@ -161,7 +176,7 @@ float DW1000Time::getAsFloat() const {
  * @return time in micro seconds
  */
 float DW1000Time::getAsMicroSeconds() const {
-	return (_timestamp%TIME_OVERFLOW)*TIME_RES;
+	return reduced(_timestamp)*TIME_RES;
 }
 
 /**
@@ -171,7 +186,61 @@ float DW1000Time::getAsMicroSeconds() const {
  */
 float DW1000Time::getAsMeters() const {
 	//return fmod((float)_timestamp, TIME_OVERFLOW)*DISTANCE_OF_RADIO;
-	return (_timestamp%TIME_OVERFLOW)*DISTANCE_OF_RADIO;
+	return reduced(_timestamp)*DISTANCE_OF_RADIO;
+}
+
+/**
+ * Return time as distance in millimeter without float arithmetic, e.g. for a time of flight
+ * @return distance in millimeters, valid up to about 2000 km
+ */
+int32_t DW1000Time::getAsMillimeters() const {
+	return ticksToMillimeters((int32_t)_timestamp);
+}
+
+/**
+ * Format timestamp as decimal integer, e.g. for logging
+ * printf for arduino avr do not support int64, and a 64 bit division per digit is slow,
+ * so the value is split into chunks of 9 digits which are formatted with 32 bit arithmetic;
+ * a 40 bit timestamp needs one 64 bit division
+ * @param buf destination of at least LENGTH_DECIMAL chars, not terminated
+ * @return number of chars
+ */
+uint8_t DW1000Time::toChars(char buf[]) const {
+	static constexpr uint32_t CHUNK = 1000000000UL;
+	char     digits[LENGTH_DECIMAL];
+	uint8_t  i      = LENGTH_DECIMAL;
+	uint64_t number = _timestamp < 0 ? -(uint64_t)_timestamp : (uint64_t)_timestamp;
+	while(number >= CHUNK) {
+		uint64_t q     = number/CHUNK;
+		uint32_t chunk = (uint32_t)number-(uint32_t)q*CHUNK; // exact modulo 2^32
+		for(uint8_t k = 0; k < 9; k++) {
+			digits[--i] = '0'+chunk%10;
+			chunk /= 10;
+		}
+		number = q;
+	}
+	uint32_t chunk = (uint32_t)number;
+	do {
+		digits[--i] = '0'+chunk%10;
+		chunk /= 10;
+	} while(chunk > 0);
+	uint8_t n = 0;
+	if(_timestamp < 0) {
+		buf[n++] = '-';
+	}
+	memcpy(buf+n, digits+i, LENGTH_DECIMAL-i);
+	return n+LENGTH_DECIMAL-i;
+}
+
+/**
+ * Write the raw timestamp of instance (lower 40 bit, little endian) with e.g. Serial.write()
+ * @param p printer instance
+ * @return number of written bytes
+ */
+size_t DW1000Time::writeTo(Print& p) const {
+	byte data[LENGTH_TIMESTAMP];
+	getTimestamp(data);
+	return p.write(data, LENGTH_TIMESTAMP);
 }
 
 /**
@@ -295,29 +364,7 @@ void DW1000Time::print() {
  * @return size of printed chars
  */
 size_t DW1000Time::printTo(Print& p) const {
-	int64_t       number  = _timestamp;
-	unsigned char buf[21];
-	uint8_t       i       = 0;
-	uint8_t       printed = 0;
-	// printf for arduino avr do not support int64, so we have to calculate
-	if(number == 0) {
-		p.print((char)'0');
-		return 1;
-	}
-	if(number < 0) {
-		p.print((char)'-');
-		number = -number; // make positive
-		printed++;
-	}
-	while(number > 0) {
-		int64_t q = number/10;
-		buf[i++] = number-q*10;
-		number = q;
-	}
-	printed += i;
-	for(; i > 0; i--)
-		p.print((char)(buf[i-1] < 10 ? '0'+buf[i-1] : 'A'+buf[i-1]-10));
-	
-	return printed;
+	char buf[LENGTH_DECIMAL];
+	return p.write((const uint8_t*)buf, toChars(buf));
 }
 #endif // DW1000Time_H_PRINTABLE
@@ -21,6 +21,7 @@
  * 
  * @TODO
  * - avoid/remove floating operations, expensive on most microprocessors
+ *   (integer conversions are available, see microsecondsToTicks() etc.)
  * 
  * @note
  * comments in cpp file, makes .h smaller and gives a better overview about
@@ -54,18 +55,50 @@ public:
 	
 	// timestamp byte length - 40 bit -> 5 byte
 	static constexpr uint8_t LENGTH_TIMESTAMP = 5;
+	// maximum number of chars of a timestamp as decimal, with sign: -9223372036854775808
+	static constexpr uint8_t LENGTH_DECIMAL = 20;
 	
 	// timer/counter overflow (40 bits) -> 4overflow approx. every 17.2 seconds
 	static constexpr int64_t TIME_OVERFLOW = 0x10000000000; //1099511627776LL
 	static constexpr int64_t TIME_MAX      = 0xffffffffff;
 	
 	// time factors (relative to [us]) for setting delayed transceive
-	// TODO use non float
+	// exact for the integer conversions below, see setTime(int32_t, float)
 	static constexpr float SECONDS      = 1e6;
 	static constexpr float MILLISECONDS = 1e3;
 	static constexpr float MICROSECONDS = 1;
 	static constexpr float NANOSECONDS  = 1e-3;
 	
+	// integer conversions without float, 1 us = 63897.6 = 63897 + 3/5 ticks (exact),
+	// distances in fixed point: 1 tick = 4.6917639786 mm (Q20), 1 mm = 0.2131394513 ticks (Q24)
+	static constexpr int64_t  TICKS_PER_MILLISECOND    = 63897600;
+	static constexpr int64_t  TICKS_PER_SECOND         = 63897600000;
+	static constexpr uint32_t MILLIMETERS_PER_TICK_Q20 = 4919671;
+	static constexpr uint32_t TICKS_PER_MILLIMETER_Q24 = 3575887;
+	
+	// 32 bit divisions only, 64 bit ones are expensive on AVR
+	static constexpr int64_t microsecondsToTicks(int32_t us) {
+		return (int64_t)us*63897+us/5*3+us%5*3/5;
+	}
+	static constexpr int64_t millisecondsToTicks(int32_t ms) {
+		return (int64_t)ms*TICKS_PER_MILLISECOND;
+	}
+	static constexpr int64_t nanosecondsToTicks(int32_t ns) {
+		// 63.8976 = 63 + 561/625
+		return (int64_t)ns*63+ns/625*561+ns%625*561/625;
+	}
+	// ticks (0 to TIME_MAX) to [us], truncated; 63897.6 = 2^13 * 39 / 5
+	static constexpr int32_t ticksToMicroseconds(int64_t ticks) {
+		return (uint32_t)((uint64_t)(ticks*5) >> 13)/39;
+	}
+	// e.g. a time of flight to a distance, rounded
+	static constexpr int32_t ticksToMillimeters(int32_t ticks) {
+		return ticks < 0 ? -ticksToMillimeters(-ticks) : (int32_t)(((int64_t)ticks*MILLIMETERS_PER_TICK_Q20+(1L << 19)) >> 20);
+	}
+	static constexpr int32_t millimetersToTicks(int32_t mm) {
+		return mm < 0 ? -millimetersToTicks(-mm) : (int32_t)(((int64_t)mm*TICKS_PER_MILLIMETER_Q24+(1L << 23)) >> 24);
+	}
+	
 	// constructor
 	DW1000Time();
 	DW1000Time(int64_t time);
@@ -78,7 +111,7 @@ public:
 	// setter
 	// dw1000 timestamp, increase of +1 approx approx. 15.65ps real time
 	void setTimestamp(int64_t value);
-	void setTimestamp(byte data[]);
+	void setTimestamp(const byte data[]);
 	void setTimestamp(const DW1000Time& copy);
 	
 	// real time in us
@@ -95,6 +128,13 @@ public:
 	float getAsMicroSeconds() const;
 	//void getAsBytes(byte data[]) const; // TODO check why it is here, is it old version of getTimestamp(byte) ?
 	float getAsMeters() const;
+	// without float, for distances up to about 2000 km (e.g. time of flight)
+	int32_t getAsMillimeters() const;
+	
+	// decimal chars (not terminated) into buf, at least LENGTH_DECIMAL long; returns the count
+	uint8_t toChars(char buf[]) const;
+	// raw 5 byte timestamp (little endian, as in the registers) for machine consumption
+	size_t  writeTo(Print& p) const;
 	
 	DW1000Time& wrap();
 	
@@ -0,0 +1,142 @@
+/*
+ * Decawave DW1000 library for arduino.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file DW1000Timestamp.h
+ * A point in time of the 40 bit DW1000 system clock, which wraps around
+ * about every 17.2 seconds.
+ *
+ * @note
+ * Values are always kept masked to 40 bits, so adding or subtracting never
+ * needs a 64 bit modulo. Differences are durations (DW1000Time) and are
+ * correct across a rollover as long as both points are less than half a
+ * period (8.6 s) apart; the same holds for comparisons. Everything is inline,
+ * these are the hot paths of ranging.
+ */
+
+#ifndef _DW1000Timestamp_H_INCLUDED
+#define _DW1000Timestamp_H_INCLUDED
+
+#include <Arduino.h>
+#include "DW1000Time.h"
+
+class DW1000Timestamp {
+public:
+	static constexpr uint64_t MASK = 0xFFFFFFFFFFULL;
+	static constexpr uint64_t HALF = 0x8000000000ULL;
+
+	constexpr DW1000Timestamp() : _ticks(0) {}
+	explicit constexpr DW1000Timestamp(uint64_t ticks) : _ticks(ticks & MASK) {}
+	// any (e.g. not yet wrapped or negative) time is reduced to the clock period
+	explicit DW1000Timestamp(const DW1000Time& time) : _ticks((uint64_t)time.getTimestamp() & MASK) {}
+	explicit DW1000Timestamp(const byte data[]) { setTimestamp(data); }
+
+	// from/to the 5 byte (little endian) register format
+	void setTimestamp(const byte data[]) {
+		_ticks = 0;
+		for(uint8_t i = DW1000Time::LENGTH_TIMESTAMP; i > 0; i--) {
+			_ticks = (_ticks << 8) | data[i-1];
+		}
+	}
+	void getTimestamp(byte data[]) const {
+		uint64_t ticks = _ticks;
+		for(uint8_t i = 0; i < DW1000Time::LENGTH_TIMESTAMP; i++) {
+			data[i] = (byte)ticks;
+			ticks >>= 8;
+		}
+	}
+
+	uint64_t getTicks() const { return _ticks; }
+
+	// raw 5 bytes (little endian) for machine consumption, e.g. Serial
+	size_t writeTo(Print& p) const {
+		byte data[DW1000Time::LENGTH_TIMESTAMP];
+		getTimestamp(data);
+		return p.write(data, DW1000Time::LENGTH_TIMESTAMP);
+	}
+
+	// explicit conversion to a time (0 to TIME_MAX), e.g. to print it
+	DW1000Time toTime() const { return DW1000Time((int64_t)_ticks); }
+
+	/**
+	Signed duration from `earlier` to this point, -2^39 to 2^39-1 ticks.
+	*/
+	int64_t since(const DW1000Timestamp& earlier) const {
+		uint64_t diff = (_ticks-earlier._ticks) & MASK;
+		return diff >= HALF ? (int64_t)diff-(int64_t)(MASK+1) : (int64_t)diff;
+	}
+
+	DW1000Time operator-(const DW1000Timestamp& earlier) const { return DW1000Time(since(earlier)); }
+
+	DW1000Timestamp& operator+=(const DW1000Time& duration) {
+		_ticks = (_ticks+(uint64_t)duration.getTimestamp()) & MASK;
+		return *this;
+	}
+	DW1000Timestamp& operator-=(const DW1000Time& duration) {
+		_ticks = (_ticks-(uint64_t)duration.getTimestamp()) & MASK;
+		return *this;
+	}
+	DW1000Timestamp operator+(const DW1000Time& duration) const { return DW1000Timestamp(*this) += duration; }
+	DW1000Timestamp operator-(const DW1000Time& duration) const { return DW1000Timestamp(*this) -= duration; }
+
+	// compare, wrap-safe (see note above)
+	boolean operator==(const DW1000Timestamp& cmp) const { return _ticks == cmp._ticks; }
+	boolean operator!=(const DW1000Timestamp& cmp) const { return _ticks != cmp._ticks; }
+	boolean operator<(const DW1000Timestamp& cmp) const { return since(cmp) < 0; }
+	boolean operator>(const DW1000Timestamp& cmp) const { return since(cmp) > 0; }
+	boolean operator<=(const DW1000Timestamp& cmp) const { return since(cmp) <= 0; }
+	boolean operator>=(const DW1000Timestamp& cmp) const { return since(cmp) >= 0; }
+
+private:
+	uint64_t _ticks;
+};
+
+/**
+Storage of a DW1000Timestamp in 5 bytes (little endian, the register layout) instead of 8,
+e.g. for the timestamps of every known device. Converts implicitly from and to DW1000Timestamp,
+calculate with the latter.
+*/
+class DW1000PackedTimestamp {
+public:
+	DW1000PackedTimestamp() { memset(_data, 0, sizeof(_data)); }
+	DW1000PackedTimestamp(const DW1000Timestamp& time) { time.getTimestamp(_data); }
+
+	operator DW1000Timestamp() const { return DW1000Timestamp(_data); }
+	DW1000Time toTime() const { return DW1000Timestamp(_data).toTime(); }
+
+	void setTimestamp(const byte data[]) { memcpy(_data, data, sizeof(_data)); }
+	void getTimestamp(byte data[]) const { memcpy(data, _data, sizeof(_data)); }
+
+	// the part of the DW1000Time interface the device timestamps were used with
+	void    setTimestamp(const DW1000Time& time) { DW1000Timestamp(time).getTimestamp(_data); }
+	int64_t getTimestamp() const { return (int64_t)DW1000Timestamp(_data).getTicks(); }
+	float   getAsMicroSeconds() const { return toTime().getAsMicroSeconds(); }
+	float   getAsMeters() const { return toTime().getAsMeters(); }
+#if DW1000TIME_H_PRINTABLE
+	// no Printable (its vtable pointer would cost as much as packing saves), print toTime() instead
+	void    print() const { Serial.println(toTime()); }
+#endif
+
+	// durations between and from points in time, wrap-safe as with DW1000Timestamp
+	DW1000Time operator-(const DW1000PackedTimestamp& earlier) const {
+		return DW1000Timestamp(_data)-DW1000Timestamp(earlier._data);
+	}
+	DW1000Timestamp operator+(const DW1000Time& duration) const { return DW1000Timestamp(_data)+duration; }
+	DW1000Timestamp operator-(const DW1000Time& duration) const { return DW1000Timestamp(_data)-duration; }
+
+private:
+	byte _data[DW1000Time::LENGTH_TIMESTAMP];
+};
+
+#endif
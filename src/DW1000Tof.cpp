@@ -0,0 +1,128 @@
+/*
+ * Decawave DW1000 library for arduino.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file DW1000Tof.cpp
+ * Time of flight of asymmetric double-sided two-way ranging.
+ */
+
+#include "DW1000Tof.h"
+
+// durations are at most 40 bit, so the sum of all four is below 2^42
+static constexpr int64_t DURATION_MAX = 0xFFFFFFFFFFLL;
+
+#if defined(__SIZEOF_INT128__) && !defined(DW1000TOF_NO_INT128)
+
+typedef unsigned __int128 uint128_t;
+
+static uint64_t divideRounded(uint128_t numerator, uint64_t divisor) {
+	return (uint64_t)((numerator+(divisor >> 1))/divisor);
+}
+
+static uint128_t multiply(uint64_t a, uint64_t b) {
+	return (uint128_t)a*b;
+}
+
+#else
+
+// the (rounded) time of flight is below 2^41, see computeAsymmetricExact()
+static constexpr uint8_t QUOTIENT_BITS = 42;
+
+// no native 128 bit type (AVR, ARM), the few operations needed with two 64 bit halves
+struct uint128_t {
+	uint64_t high;
+	uint64_t low;
+
+	bool operator<(const uint128_t& cmp) const {
+		return high < cmp.high || (high == cmp.high && low < cmp.low);
+	}
+	uint128_t operator-(const uint128_t& b) const {
+		uint128_t r;
+		r.low  = low-b.low;
+		r.high = high-b.high-(low < b.low ? 1 : 0);
+		return r;
+	}
+};
+
+static uint128_t multiply(uint64_t a, uint64_t b) {
+	uint64_t aLow  = (uint32_t)a, aHigh = a >> 32;
+	uint64_t bLow  = (uint32_t)b, bHigh = b >> 32;
+	uint64_t low   = aLow*bLow;
+	uint64_t mid1  = aHigh*bLow;
+	uint64_t mid2  = aLow*bHigh;
+	uint64_t carry = (low >> 32)+(uint32_t)mid1+(uint32_t)mid2;
+	uint128_t r;
+	r.low  = (carry << 32) | (uint32_t)low;
+	r.high = aHigh*bHigh+(mid1 >> 32)+(mid2 >> 32)+(carry >> 32);
+	return r;
+}
+
+/*
+ * Shift-subtract division, only over the QUOTIENT_BITS the quotient can have:
+ * everything above them is shifted into the remainder at once (numerator < 2^81).
+ */
+static uint64_t divideRounded(uint128_t numerator, uint64_t divisor) {
+	uint64_t half = divisor >> 1;
+	numerator.low  += half;
+	numerator.high += numerator.low < half ? 1 : 0;
+	uint64_t remainder = (numerator.high << (64-QUOTIENT_BITS)) | (numerator.low >> QUOTIENT_BITS);
+	uint64_t low       = numerator.low << (64-QUOTIENT_BITS);
+	uint64_t quotient  = 0;
+	for(uint8_t i = 0; i < QUOTIENT_BITS; i++) {
+		remainder = (remainder << 1) | (low >> 63);
+		low <<= 1;
+		quotient <<= 1;
+		if(remainder >= divisor) {
+			remainder -= divisor;
+			quotient |= 1;
+		}
+	}
+	return quotient;
+}
+
+#endif
+
+static inline bool isValid(int64_t round1, int64_t reply1, int64_t round2, int64_t reply2) {
+	return 0 <= round1 && round1 <= DURATION_MAX && 0 <= reply1 && reply1 <= DURATION_MAX
+	       && 0 <= round2 && round2 <= DURATION_MAX && 0 <= reply2 && reply2 <= DURATION_MAX
+	       && (round1 | reply1 | round2 | reply2) != 0;
+}
+
+/*
+ * With all durations non-negative, the quotient is below min(round1, round2) for a positive
+ * and below min(reply1, reply2) for a negative numerator, i.e. below 2^40 (2^41 rounded).
+ */
+int64_t DW1000Tof::computeAsymmetricExact(int64_t round1, int64_t reply1, int64_t round2, int64_t reply2) {
+	if(!isValid(round1, reply1, round2, reply2)) {
+		return 0;
+	}
+	uint64_t  sum    = round1+round2+reply1+reply2;
+	uint128_t rounds = multiply(round1, round2);
+	uint128_t replys = multiply(reply1, reply2);
+	if(rounds < replys) {
+		return -(int64_t)divideRounded(replys-rounds, sum);
+	}
+	return divideRounded(rounds-replys, sum);
+}
+
+int64_t DW1000Tof::computeAsymmetricFloat(int64_t round1, int64_t reply1, int64_t round2, int64_t reply2) {
+	if(!isValid(round1, reply1, round2, reply2)) {
+		return 0;
+	}
+	// exact (cheap) 64 bit differences and sum, float only for the products
+	float x   = (float)(round1-reply1);
+	float y   = (float)(round2-reply2);
+	float tof = ((float)round1*y+(float)round2*x-x*y)/(float)(round1+round2+reply1+reply2);
+	return (int64_t)(tof < 0 ? tof-0.5f : tof+0.5f);
+}
@@ -0,0 +1,61 @@
+/*
+ * Decawave DW1000 library for arduino.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * @file DW1000Tof.h
+ * Time of flight of asymmetric double-sided two-way ranging.
+ *
+ * @note
+ * tof = (round1*round2 - reply1*reply2) / (round1 + round2 + reply1 + reply2)
+ *
+ * The durations are differences of 40 bit timestamps (DW1000Timestamp::since()),
+ * signed 40 bit, so they are only meaningful up to 2^39 (half the timer wrap,
+ * about 8.6 s). The kernels take up to 40 bit, so both products need up to
+ * 80 bit. With x = round1-reply1 and y = round2-reply2 (twice the time of
+ * flight plus the clock drift over the reply time, i.e. small) the numerator is
+ * round1*y + round2*x - x*y, which is what the float kernel computes.
+ *
+ * Does not depend on Arduino.h, so the kernels can be built and checked on a
+ * host, see extras/tools/tof_bench.cpp.
+ */
+
+#ifndef _DW1000Tof_H_INCLUDED
+#define _DW1000Tof_H_INCLUDED
+
+#include <stdint.h>
+#include "DW1000CompileOptions.h"
+
+class DW1000Tof {
+public:
+	/**
+	Time of flight from the four durations of a double-sided exchange, with the precision
+	selected by DW1000TOF_PRECISION (see DW1000CompileOptions.h).
+
+	@param[in] round1, reply1, round2, reply2 Durations [time units], 0 to 2^39 (see above).
+	@return Time of flight [time units], rounded; 0 if a duration is negative or all are 0.
+	*/
+	static int64_t computeAsymmetric(int64_t round1, int64_t reply1, int64_t round2, int64_t reply2) {
+#if DW1000TOF_PRECISION == DW1000TOF_FLOAT
+		return computeAsymmetricFloat(round1, reply1, round2, reply2);
+#else
+		return computeAsymmetricExact(round1, reply1, round2, reply2);
+#endif
+	}
+
+	// both kernels, e.g. to compare them; only the one in use is linked
+	static int64_t computeAsymmetricExact(int64_t round1, int64_t reply1, int64_t round2, int64_t reply2);
+	static int64_t computeAsymmetricFloat(int64_t round1, int64_t reply1, int64_t round2, int64_t reply2);
+};
+
+#endif